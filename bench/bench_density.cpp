@@ -0,0 +1,103 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Scatter sets of growing size plotted as points and as density: binning alone on 1 to many threads,
+// and whole plots (binning, data and gnuplot) with the stub gnuplot, so the cost of the plot on our side is seen.
+// usage: simplePlot_bench_density [max points] [bins per axis] [threads]
+
+#include "GnuplotDriver.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace std;
+
+#ifndef SIMPLEPLOT_STUB_DIR
+#define SIMPLEPLOT_STUB_DIR "bin/stub"
+#endif
+
+template<typename F>
+static double seconds(const F& f) {
+
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+}
+
+int main(int argc, char** argv){
+
+    const size_t maxPoints = (argc > 1) ? (size_t) strtod(argv[1], NULL) : 10000000;
+    const size_t bins = (argc > 2) ? strtoull(argv[2], NULL, 10) : 256;
+    size_t threads = (argc > 3) ? strtoull(argv[3], NULL, 10) : thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    const char* path = getenv("PATH");
+    const string stubPath = string(SIMPLEPLOT_STUB_DIR) + ":" + (path ? path : "");
+    setenv("PATH", stubPath.c_str(), 1);
+
+    // a correlated gaussian cloud
+    mt19937_64 generator(1);
+    normal_distribution<double> normal;
+    vector<double> x(maxPoints), y(maxPoints);
+    for (size_t i = 0; i < maxPoints; ++i) {
+        x[i] = normal(generator);
+        y[i] = 0.5 * x[i] + normal(generator);
+    }
+
+    char file[] = "/tmp/simplePlot_bench_density_XXXXXX.png";
+    const int fd = mkstemps(file, 4);
+    if (fd < 0) {
+        cout << "could not create a file in /tmp" << endl;
+        return 1;
+    }
+    close(fd);
+
+    printf("%-12s %-14s %-14s %-14s %-14s\n", "points", "bin 1 thr ms", "bin N thr ms", "points ms", "density ms");
+
+    for (size_t n = 100000; n <= maxPoints; n *= 10) {
+        const DataView xs(x.data(), n), ys(y.data(), n);
+
+        const double serial = seconds([&]() {
+            Histogram2D histogram(bins, bins, -5, 5, -5, 5);
+            histogram.add(xs, ys, 1);
+        });
+        const double parallel = seconds([&]() {
+            Histogram2D histogram(bins, bins, -5, 5, -5, 5);
+            histogram.add(xs, ys, threads);
+        });
+
+        GnuplotDriver driver(gnuplot_axis_type::GNUPLOT_LINEAR, gnuplot_action_type::GNUPLOT_SAVE, file);
+        driver.setDataFormat(gnuplot_data_format::GNUPLOT_BINARY);
+        driver.setPlotOptions("with dots");
+        const double points = seconds([&]() { driver.plot(xs, ys); });
+
+        DensityOptions options;
+        options.xBins = bins;
+        options.yBins = bins;
+        options.threads = threads;
+        const double density = seconds([&]() { driver.plotDensity(xs, ys, options); });
+
+        printf("%-12zu %-14.3f %-14.3f %-14.3f %-14.3f\n", n, serial * 1e3, parallel * 1e3, points * 1e3, density * 1e3);
+    }
+
+    unlink(file);
+
+}
@@ -0,0 +1,102 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Values formatted per second: iostream operator<< against formatDouble through TextWriter.
+// Every method writes the same rows ("x y\n") in memory; "exact" tells if all values read back unchanged.
+// usage: simplePlot_bench_format [number of points]
+
+#include "NumberFormat.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace std;
+
+static bool readsBack(const string& text, const vector<double>& x, const vector<double>& y) {
+
+    istringstream in(text);
+    string a, b;
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (!(in >> a >> b)) return false;
+        if (strtod(a.c_str(), NULL) != x[i] || strtod(b.c_str(), NULL) != y[i]) return false;
+    }
+    return true;
+
+}
+
+static void report(const char* method, const double& seconds, const size_t& nValues, const string& text,
+                   const vector<double>& x, const vector<double>& y) {
+
+    printf("%-26s %-10.4f %-12.2f %-10.1f %s\n", method, seconds, nValues / seconds * 1e-6,
+           text.size() / seconds * 1e-6, readsBack(text, x, y) ? "yes" : "no");
+
+}
+
+int main(int argc, char** argv){
+
+    const size_t n = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    // a grid (exact decimals), a smooth signal (needs 16-17 digits) and integers
+    vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = (i % 3 == 2) ? (double) i : i * 1e-3;
+        y[i] = sin(x[i]) * exp(-x[i] * 1e-2);
+    }
+
+    cout << "method                     time [s]   Mvalues/s    MB/s       exact" << endl;
+
+    // -1: the way data used to be written
+    const int streamPrecisions[] = {-1, 6, 17};
+    for (const int& precision : streamPrecisions) {
+        ostringstream out;
+        auto start = chrono::steady_clock::now();
+        if (precision < 0) {
+            for (size_t i = 0; i < n; ++i) out << x[i] << " " << y[i] << endl;
+        } else {
+            out << setprecision(precision);
+            for (size_t i = 0; i < n; ++i) out << x[i] << " " << y[i] << "\n";
+        }
+        const double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        const string method = (precision < 0) ? "iostream, default, endl" : "iostream, " + to_string(precision) + " digits";
+        report(method.c_str(), t, 2 * n, out.str(), x, y);
+    }
+
+    const int writerPrecisions[] = {0, 6, 17};
+    for (const int& precision : writerPrecisions) {
+        ostringstream out;
+        auto start = chrono::steady_clock::now();
+        {
+            TextWriter writer(out, precision);
+            for (size_t i = 0; i < n; ++i) {
+                writer.put(x[i]);
+                writer.put(' ');
+                writer.put(y[i]);
+                writer.put('\n');
+            }
+        }
+        const double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        const string method = (precision == 0) ? "TextWriter, shortest" : "TextWriter, " + to_string(precision) + " digits";
+        report(method.c_str(), t, 2 * n, out.str(), x, y);
+    }
+
+}
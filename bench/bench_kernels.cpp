@@ -0,0 +1,131 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Throughput of the range and filter kernels (DataKernels.h) with every instruction set the cpu supports,
+// and of the XXH64 hash of the render cache (RenderCache.h), checked first against reference values.
+// Data is much larger than the caches, so the best version should run close to memory bandwidth.
+// usage: simplePlot_bench_kernels [number of points]
+
+#include "DataKernels.h"
+#include "RenderCache.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+static const char* levelName(const gnuplot_simd& level) {
+
+    switch (level) {
+    case gnuplot_simd::GNUPLOT_AVX2: return "avx2";
+    case gnuplot_simd::GNUPLOT_SSE2: return "sse2";
+    default: return "scalar";
+    }
+
+}
+
+// best of 5 runs of kernel, in seconds
+template<typename Kernel>
+static double bestTime(const Kernel& kernel) {
+
+    double best = 1e30;
+    for (int r = 0; r < 5; ++r) {
+        auto start = chrono::steady_clock::now();
+        kernel();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+
+}
+
+// XXH64 of text, given to the hasher in pieces of step bytes
+static uint64_t hashOf(const char* text, const size_t& step) {
+
+    Hasher64 hasher;
+    const size_t n = strlen(text);
+    for (size_t i = 0; i < n; i += step) hasher.update(text + i, min(step, n - i));
+    return hasher.digest();
+
+}
+
+// reference values of XXH64 with seed 0: short inputs, and one long enough to fill the 32 byte stripes
+static bool hashMatchesReference() {
+
+    const struct { const char* text; uint64_t hash; } reference[] = {
+        {"", 0xEF46DB3751D8E999ULL},
+        {"a", 0xD24EC4F1A98C6E5BULL},
+        {"abc", 0x44BC2CF5AD770999ULL},
+        {"Nobody inspects the spammish repetition", 0xFBCEA83C8A378BF1ULL}
+    };
+
+    for (const auto& r : reference) {
+        for (size_t step : {(size_t) 1, (size_t) 7, (size_t) 64}) {
+            if (hashOf(r.text, step) != r.hash) return false;
+        }
+    }
+    return true;
+
+}
+
+int main(int argc, char** argv){
+
+    const size_t n = (argc > 1) ? strtoull(argv[1], NULL, 10) : 20000000;
+
+    // a few values a log axis cannot show, so every branch is taken
+    vector<double> x(n), y(n), outX(n), outY(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 1 + i * 1e-3;
+        y[i] = (i % 1000 == 999) ? NAN : sin(x[i]) + 1.5;
+    }
+
+    const gnuplot_simd best = simdLevel();
+    cout << "kernel              simd     time [ms]   GB/s      result" << endl;
+
+    for (int level = (int) best; level >= 0; --level) {
+        setSimdLevel((gnuplot_simd) level);
+        const char* name = levelName((gnuplot_simd) level);
+
+        ValueRange range;
+        double t = bestTime([&]() { range = valueRange(y.data(), n, true); });
+        printf("%-19s %-8s %-11.2f %-9.2f %zu values in [%g, %g]\n", "valueRange", name, t * 1e3,
+               n * sizeof(double) / t * 1e-9, range.count, range.min, range.max);
+
+        size_t first = 0;
+        t = bestTime([&]() { first = firstUnplottable(x.data(), x.data(), n, true, true); });
+        printf("%-19s %-8s %-11.2f %-9.2f first at %zu\n", "firstUnplottable", name, t * 1e3,
+               2 * n * sizeof(double) / t * 1e-9, first);
+
+        size_t kept = 0;
+        t = bestTime([&]() { kept = keepPlottable(x.data(), y.data(), n, true, true, outX.data(), outY.data()); });
+        printf("%-19s %-8s %-11.2f %-9.2f %zu kept\n", "keepPlottable", name, t * 1e3,
+               4 * n * sizeof(double) / t * 1e-9, kept);
+    }
+
+    const bool reference = hashMatchesReference();
+    uint64_t hash = 0;
+    double t = bestTime([&]() {
+        Hasher64 hasher;
+        hasher.update(y.data(), n * sizeof(double));
+        hash = hasher.digest();
+    });
+    printf("%-19s %-8s %-11.2f %-9.2f %016llx, reference values: %s\n", "XXH64", "scalar", t * 1e3,
+           n * sizeof(double) / t * 1e-9, (unsigned long long) hash, reference ? "yes" : "NO");
+
+}
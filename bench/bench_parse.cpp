@@ -0,0 +1,149 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Parse throughput of text data files: a csv log is written, then read with strtod line by line, with
+// DataFile::forEachRow, and with DataFile::readColumns on 1 to many threads. Values are checked to be identical.
+// Small files with blank fields and unterminated last lines are checked first.
+// usage: simplePlot_bench_parse [rows] [threads]
+
+#include "DataFile.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+using namespace std;
+
+template<typename F>
+static double seconds(const F& f) {
+
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+}
+
+// true if text, csv, is read by forEachRow and readColumns as rows (nan where a field has no number)
+static bool readsAs(const string& text, const vector<vector<double>>& rows) {
+
+    char fileName[] = "/tmp/simplePlot_bench_parse_XXXXXX.csv";
+    const int fd = mkstemps(fileName, 4);
+    if (fd < 0 || write(fd, text.data(), text.size()) != (ssize_t) text.size()) return false;
+    close(fd);
+
+    FileLayout layout;
+    layout.separator = ',';
+    const DataFile file(fileName, layout);
+    const vector<size_t> columns = {0, 1, 2};
+
+    auto same = [](const double& a, const double& b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+    bool ok = true;
+    size_t r = 0;
+    file.forEachRow(columns, [&](const double* v) {
+        ok = ok && r < rows.size() && same(v[0], rows[r][0]) && same(v[1], rows[r][1]) && same(v[2], rows[r][2]);
+        ++r;
+    });
+    ok = ok && r == rows.size();
+
+    vector<vector<double>> values;
+    ok = ok && file.readColumns(columns, values, 1) == rows.size();
+    for (size_t k = 0; ok && k < rows.size(); ++k) {
+        for (size_t c = 0; c < 3; ++c) ok = ok && same(values[c][k], rows[k][c]);
+    }
+
+    unlink(fileName);
+    return ok;
+
+}
+
+int main(int argc, char** argv){
+
+    const double nan = numeric_limits<double>::quiet_NaN();
+    const bool blankFields = readsAs("1,2, \n3,4,5\n", {{1, 2, nan}, {3, 4, 5}}) &&
+                             readsAs("1,,3\n4, ,\t\n", {{1, nan, 3}, {4, nan, nan}}) &&
+                             readsAs("1,2, \n   ", {{1, 2, nan}}) &&
+                             readsAs("1,2,3\n4,5,6", {{1, 2, 3}, {4, 5, 6}}) &&
+                             readsAs("1,2,3\n4,5,0x1", {{1, 2, 3}, {4, 5, 1}}) &&
+                             readsAs("1,2,3\n4,5,nan", {{1, 2, 3}, {4, 5, nan}});
+    printf("blank fields and last lines read right: %s\n", blankFields ? "yes" : "NO");
+
+    const size_t nRows = (argc > 1) ? (size_t) strtod(argv[1], NULL) : 5000000;
+    size_t maxThreads = (argc > 2) ? strtoull(argv[2], NULL, 10) : thread::hardware_concurrency();
+    if (maxThreads == 0) maxThreads = 1;
+
+    // time, a measure and a counter, as written by a logger
+    char fileName[] = "/tmp/simplePlot_bench_parse_XXXXXX.csv";
+    const int fd = mkstemps(fileName, 4);
+    if (fd < 0) {
+        cout << "could not create a file in /tmp" << endl;
+        return 1;
+    }
+    FILE* out = fdopen(fd, "w");
+    mt19937_64 generator(1);
+    normal_distribution<double> normal;
+    fprintf(out, "time,value,count\n");
+    for (size_t i = 0; i < nRows; ++i) fprintf(out, "%.6f,%.9g,%zu\n", i * 1e-3, normal(generator), i % 1000);
+    fclose(out);
+
+    FileLayout layout;
+    layout.separator = ',';
+    layout.skip = 1;
+    const DataFile file(fileName, layout);
+    const double mb = file.bytes() / 1e6;
+    const vector<size_t> columns = {0, 1, 2};
+
+    // reference: every field read with strtod
+    vector<vector<double>> reference(3);
+    const MappedFile mapped(fileName);
+    const double strtodSeconds = seconds([&]() {
+        const char* p = static_cast<const char*>(memchr(mapped.data(), '\n', mapped.size())) + 1;
+        const char* end = mapped.data() + mapped.size();
+        while (p < end) {
+            char* next;
+            for (size_t k = 0; k < 3; ++k) {
+                reference[k].push_back(strtod(p, &next));
+                p = next + 1;
+            }
+        }
+    });
+
+    vector<vector<double>> rows(3);
+    const double rowSeconds = seconds([&]() {
+        file.forEachRow(columns, [&](const double* v) { for (size_t k = 0; k < 3; ++k) rows[k].push_back(v[k]); });
+    });
+
+    printf("%zu rows, %.1f MB\n\n", nRows, mb);
+    printf("%-26s %-10s %-10s %-6s\n", "", "s", "MB/s", "same");
+    printf("%-26s %-10.3f %-10.0f %-6s\n", "strtod", strtodSeconds, mb / strtodSeconds, "-");
+    printf("%-26s %-10.3f %-10.0f %-6s\n", "forEachRow", rowSeconds, mb / rowSeconds, (rows == reference) ? "yes" : "NO");
+
+    for (size_t t = 1; t <= maxThreads; t *= 2) {
+        vector<vector<double>> values;
+        const double s = seconds([&]() { file.readColumns(columns, values, t); });
+        const string name = "readColumns, " + to_string(t) + " threads";
+        printf("%-26s %-10.3f %-10.0f %-6s\n", name.c_str(), s, mb / s, (values == reference) ? "yes" : "NO");
+        if (t < maxThreads && 2 * t > maxThreads) t = maxThreads / 2;
+    }
+
+    unlink(fileName);
+
+}
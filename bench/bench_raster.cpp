@@ -0,0 +1,113 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Time to export many small png line plots: with gnuplot (from PATH, if installed) and with the
+// in-process RasterBackend on 1 and on many threads.
+// usage: simplePlot_bench_raster [figures] [threads] [points per series]
+
+#include "GnuplotDriver.h"
+#include "RasterBackend.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// exports figures [0, n) with nThreads threads, one driver per thread. Returns seconds, or -1 if a plot failed
+static double exportFigures(const shared_ptr<PlotBackend>& backend, const string& dir, const size_t& n, const size_t& nThreads,
+                            const vector<double>& x, const vector<double>& y0, const vector<double>& y1) {
+
+    atomic<size_t> next(0);
+    atomic<int> failed(0);
+
+    auto work = [&]() {
+        GnuplotDriver driver(gnuplot_axis_type::GNUPLOT_LINEAR, gnuplot_action_type::GNUPLOT_SAVE, dir + "/figure.png");
+        driver.setBackend(backend);
+        driver.setTitle("benchmark");
+        driver.setXLabel("x", 12);
+        driver.setYLabel("y", 12);
+        driver.setLegendTitles({"first", "second"});
+        driver.setStats(true);
+        size_t k;
+        while ((k = next++) < n) {
+            driver.setSaveName(dir + "/figure_" + to_string(k) + ".png");
+            driver.plot(x, y0, x, y1);
+            if (driver.lastStats().status != 0) failed = driver.lastStats().status;
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (size_t t = 0; t < nThreads; ++t) workers.push_back(thread(work));
+    for (size_t t = 0; t < nThreads; ++t) workers[t].join();
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for (size_t k = 0; k < n; ++k) unlink((dir + "/figure_" + to_string(k) + ".png").c_str());
+
+    return failed ? -1 : seconds;
+
+}
+
+static void report(const char* name, const size_t& threads, const size_t& n, const double& seconds) {
+
+    if (seconds < 0) {
+        printf("%-10s %-8zu failed (for gnuplot: is it installed?)\n", name, threads);
+        return;
+    }
+    printf("%-10s %-8zu %-9zu %-12.3f %-12.1f\n", name, threads, n, seconds / n * 1e3, n / seconds);
+
+}
+
+int main(int argc, char** argv){
+
+    const size_t figures = (argc > 1) ? strtoull(argv[1], NULL, 10) : 200;
+    size_t threads = (argc > 2) ? strtoull(argv[2], NULL, 10) : thread::hardware_concurrency();
+    const size_t points = (argc > 3) ? strtoull(argv[3], NULL, 10) : 500;
+    if (threads == 0) threads = 1;
+
+    vector<double> x(points), y0(points), y1(points);
+    for (size_t i = 0; i < points; ++i) {
+        x[i] = 10.0 * i / points;
+        y0[i] = sin(x[i]);
+        y1[i] = cos(3 * x[i]) * exp(-0.1 * x[i]);
+    }
+
+    char dir[] = "/tmp/simplePlot_bench_raster_XXXXXX";
+    if (!mkdtemp(dir)) {
+        cout << "could not create a directory in /tmp" << endl;
+        return 1;
+    }
+
+    cout << "backend    threads  figures   ms/figure    figures/s" << endl;
+
+    // gnuplot is slow: a few figures are enough
+    const size_t gnuplotFigures = min<size_t>(figures, 20);
+    report("gnuplot", 1, gnuplotFigures, exportFigures(nullptr, dir, gnuplotFigures, 1, x, y0, y1));
+
+    const shared_ptr<PlotBackend> raster = make_shared<RasterBackend>();
+    report("raster", 1, figures, exportFigures(raster, dir, figures, 1, x, y0, y1));
+    if (threads > 1) report("raster", threads, figures, exportFigures(raster, dir, figures, threads, x, y0, y1));
+
+    rmdir(dir);
+
+}
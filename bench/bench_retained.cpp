@@ -0,0 +1,105 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// A parameter sweep redrawn at every step: many series, of which one changes with the parameter shown in the
+// title. Each step is rendered by a driver on a session (everything sent again) and by a RetainedPlot (only
+// the changes sent); time and bytes sent per step are compared. gnuplot is the stub, so the cost on our side is seen.
+// usage: simplePlot_bench_retained [steps] [series] [points]
+
+#include "RetainedPlot.h"
+#include "NumberFormat.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace std;
+
+#ifndef SIMPLEPLOT_STUB_DIR
+#define SIMPLEPLOT_STUB_DIR "bin/stub"
+#endif
+
+template<typename F>
+static double seconds(const F& f) {
+
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+}
+
+int main(int argc, char** argv){
+
+    const size_t nSteps = (argc > 1) ? strtoull(argv[1], NULL, 10) : 100;
+    const size_t nSeries = (argc > 2) ? strtoull(argv[2], NULL, 10) : 8;
+    const size_t n = (argc > 3) ? (size_t) strtod(argv[3], NULL) : 10000;
+
+    const char* path = getenv("PATH");
+    const string stubPath = string(SIMPLEPLOT_STUB_DIR) + ":" + (path ? path : "");
+    setenv("PATH", stubPath.c_str(), 1);
+
+    // fixed reference curves, and the response swept with k
+    vector<double> t(n);
+    vector<vector<double>> x(nSeries), y(nSeries, vector<double>(n));
+    for (size_t i = 0; i < n; ++i) t[i] = i * 1e-3;
+    for (size_t s = 0; s < nSeries; ++s) {
+        x[s] = t;
+        for (size_t i = 0; i < n; ++i) y[s][i] = sin((s + 1) * t[i]);
+    }
+    auto sweep = [&](const size_t& step) {
+        const double k = 1 + 0.01 * step;
+        for (size_t i = 0; i < n; ++i) y[0][i] = exp(-k * t[i]) * cos(10 * k * t[i]);
+        return "k = " + formatNumber(k);
+    };
+
+    const string file = "/tmp/simplePlot_bench_retained_" + to_string(getpid()) + ".png";
+
+    GnuplotDriver driver(gnuplot_axis_type::GNUPLOT_LINEAR, gnuplot_action_type::GNUPLOT_SAVE, file);
+    driver.setSession(make_shared<GnuplotSession>(false));
+    driver.setDataTransport(gnuplot_data_transport::GNUPLOT_DATABLOCK);
+    driver.setStats(true);
+    size_t driverBytes = 0;
+    const double driverSeconds = seconds([&]() {
+        for (size_t step = 0; step < nSteps; ++step) {
+            driver.setTitle(sweep(step));
+            driver.plot(x, y);
+            driverBytes += driver.lastStats().dataBytes;
+        }
+    });
+
+    RetainedPlot plot(gnuplot_action_type::GNUPLOT_SAVE, file);
+    vector<size_t> handles;
+    for (size_t s = 0; s < nSeries; ++s) handles.push_back(plot.addSeries(x[s], y[s]));
+    size_t retainedBytes = 0;
+    const double retainedSeconds = seconds([&]() {
+        for (size_t step = 0; step < nSteps; ++step) {
+            plot.setTitle(sweep(step));
+            plot.setData(handles[0], x[0], y[0]);
+            plot.render();
+            retainedBytes += plot.lastStats().dataBytes + plot.lastStats().commandBytes;
+        }
+    });
+
+    printf("%zu steps, %zu series of %zu points, one series changing\n\n", nSteps, nSeries, n);
+    printf("%-24s %-12s %-12s\n", "", "ms / step", "kB / step");
+    printf("%-24s %-12.3f %-12.1f\n", "driver, datablocks", driverSeconds * 1e3 / nSteps, driverBytes / 1e3 / nSteps);
+    printf("%-24s %-12.3f %-12.1f\n", "retained plot", retainedSeconds * 1e3 / nSteps, retainedBytes / 1e3 / nSteps);
+
+    unlink(file.c_str());
+
+}
@@ -0,0 +1,104 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Cost of a plot for a producer: gnuplot spawned by the driver for every plot, against the same plots sent
+// to a PlotServer (run here on a thread) by one and by many client threads. gnuplot is the stub, so the cost
+// on our side is seen; the stats of the server are printed at the end.
+// usage: simplePlot_bench_server [plots] [points] [client threads]
+
+#include "GnuplotDriver.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace std;
+
+#ifndef SIMPLEPLOT_STUB_DIR
+#define SIMPLEPLOT_STUB_DIR "bin/stub"
+#endif
+
+template<typename F>
+static double seconds(const F& f) {
+
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+}
+
+static void exportPlots(const size_t& nPlots, const vector<double>& x, const vector<double>& y,
+                        const string& file, const shared_ptr<PlotClient>& server) {
+
+    GnuplotDriver driver(gnuplot_axis_type::GNUPLOT_LINEAR, gnuplot_action_type::GNUPLOT_SAVE, file);
+    driver.setDataFormat(gnuplot_data_format::GNUPLOT_BINARY);
+    if (server) driver.setServer(server);
+    for (size_t k = 0; k < nPlots; ++k) driver.plot(x, y);
+
+}
+
+int main(int argc, char** argv){
+
+    const size_t nPlots = (argc > 1) ? strtoull(argv[1], NULL, 10) : 200;
+    const size_t n = (argc > 2) ? (size_t) strtod(argv[2], NULL) : 1000;
+    size_t nClients = (argc > 3) ? strtoull(argv[3], NULL, 10) : thread::hardware_concurrency();
+    if (nClients == 0) nClients = 1;
+
+    const char* path = getenv("PATH");
+    const string stubPath = string(SIMPLEPLOT_STUB_DIR) + ":" + (path ? path : "");
+    setenv("PATH", stubPath.c_str(), 1);
+
+    vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = i;
+        y[i] = i * 0.5;
+    }
+
+    const string socket = "/tmp/simplePlot_bench_server_" + to_string(getpid()) + ".sock";
+    const string file = "/tmp/simplePlot_bench_server_" + to_string(getpid()) + ".png";
+
+    PlotServer server(socket);
+    thread serverThread([&]() { server.run(); });
+
+    const double local = seconds([&]() { exportPlots(nPlots, x, y, file, nullptr); });
+    const double remote = seconds([&]() { exportPlots(nPlots, x, y, file, make_shared<PlotClient>(socket)); });
+    const double concurrent = seconds([&]() {
+        vector<thread> clients;
+        for (size_t c = 0; c < nClients; ++c) {
+            clients.push_back(thread([&, c]() {
+                exportPlots(nPlots, x, y, file + "." + to_string(c), make_shared<PlotClient>(socket));
+            }));
+        }
+        for (size_t c = 0; c < clients.size(); ++c) clients[c].join();
+    });
+
+    printf("%zu plots of %zu points\n\n", nPlots, n);
+    printf("%-28s %-12s\n", "", "ms / plot");
+    printf("%-28s %-12.3f\n", "spawned gnuplot", local * 1e3 / nPlots);
+    printf("%-28s %-12.3f\n", "server, 1 client", remote * 1e3 / nPlots);
+    printf("%-28s %-12.3f  (%zu clients)\n\n", "server, concurrent clients", concurrent * 1e3 / (nPlots * nClients), nClients);
+
+    cout << server.stats().toText();
+
+    server.stop();
+    serverThread.join();
+
+    unlink(file.c_str());
+    for (size_t c = 0; c < nClients; ++c) unlink((file + "." + to_string(c)).c_str());
+
+}
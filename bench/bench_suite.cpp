@@ -0,0 +1,181 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Latency and throughput of GnuplotDriver over number of points, number of series, action and data format.
+// gnuplot is replaced by the stub built in bin/stub (see stub_gnuplot.cpp), so only the library is measured.
+//
+// usage: simplePlot_bench [options]
+//   --min-points N      smallest number of points, default 1e3
+//   --max-points N      largest number of points (x10 steps), default 1e7. 1e8 needs about 2 GB of memory
+//   --series a,b,...    number of series the points are split in, default 1,4,16
+//   --modes a,b,...     plot, png, eps, video, default all
+//   --formats a,b,...   text, binary, default both
+//   --reps N            plots per configuration, default depends on the number of points
+//   --session           plots through a persistent GnuplotSession
+//   --real-gnuplot      uses gnuplot from PATH instead of the stub
+
+#include "GnuplotDriver.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+#ifndef SIMPLEPLOT_STUB_DIR
+#define SIMPLEPLOT_STUB_DIR "bin/stub"
+#endif
+
+static vector<string> splitList(const string& list) {
+
+    vector<string> items;
+    stringstream in(list);
+    string item;
+    while (getline(in, item, ',')) if (!item.empty()) items.push_back(item);
+    return items;
+
+}
+
+static double percentile(const vector<double>& sorted, const double& q) {
+
+    return sorted[min(sorted.size() - 1, (size_t) (q * (sorted.size() - 1) + 0.5))];
+
+}
+
+// one plot (or animation) of x, y with a new driver, returns the data bytes written
+static size_t plotOnce(const string& mode, const gnuplot_data_format& format, const shared_ptr<GnuplotSession>& session,
+                       const vector<vector<double>>& x, const vector<vector<double>>& y) {
+
+    gnuplot_action_type action = gnuplot_action_type::GNUPLOT_PLOT;
+    gnuplot_save_type saveType = gnuplot_save_type::GNUPLOT_PNG;
+    string fileName = "/tmp/simplePlot_bench.png";
+    if (mode == "png" || mode == "eps") action = gnuplot_action_type::GNUPLOT_SAVE;
+    if (mode == "eps") {
+        saveType = gnuplot_save_type::GNUPLOT_EPS;
+        fileName = "/tmp/simplePlot_bench.eps";
+    }
+    if (mode == "video") action = gnuplot_action_type::GNUPLOT_VIDEO;
+
+    GnuplotDriver plt(gnuplot_axis_type::GNUPLOT_LINEAR, action, fileName, saveType);
+    plt.setDataFormat(format);
+    plt.setStats(true);
+    if (session) plt.setSession(session);
+
+    if (action == gnuplot_action_type::GNUPLOT_VIDEO) {
+        // every series is a frame
+        for (size_t s = 0; s < y.size(); ++s) plt.plot(x[0], y[s]);
+        plt.playAnimation(x[0], 0);
+    } else {
+        plt.plot(x, y);
+    }
+
+    return plt.lastStats().dataBytes;
+
+}
+
+int main(int argc, char** argv){
+
+    size_t minPoints = 1000;
+    size_t maxPoints = 10000000;
+    vector<string> seriesList = {"1", "4", "16"};
+    vector<string> modes = {"plot", "png", "eps", "video"};
+    vector<string> formats = {"text", "binary"};
+    size_t reps = 0;
+    bool useSession = false;
+    bool realGnuplot = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--min-points" && hasValue) minPoints = (size_t) atof(argv[++i]);
+        else if (arg == "--max-points" && hasValue) maxPoints = (size_t) atof(argv[++i]);
+        else if (arg == "--series" && hasValue) seriesList = splitList(argv[++i]);
+        else if (arg == "--modes" && hasValue) modes = splitList(argv[++i]);
+        else if (arg == "--formats" && hasValue) formats = splitList(argv[++i]);
+        else if (arg == "--reps" && hasValue) reps = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--session") useSession = true;
+        else if (arg == "--real-gnuplot") realGnuplot = true;
+        else {
+            cout << "usage: simplePlot_bench [--min-points N] [--max-points N] [--series 1,4,16] [--modes plot,png,eps,video]\n"
+                    "                        [--formats text,binary] [--reps N] [--session] [--real-gnuplot]" << endl;
+            return 1;
+        }
+    }
+
+    if (!realGnuplot) {
+        const char* path = getenv("PATH");
+        const string stubPath = string(SIMPLEPLOT_STUB_DIR) + ":" + (path ? path : "");
+        setenv("PATH", stubPath.c_str(), 1);
+    }
+
+    shared_ptr<GnuplotSession> session;
+    if (useSession) session = make_shared<GnuplotSession>(false);
+
+    cout << "# gnuplot: " << (realGnuplot ? "real" : "stub in " SIMPLEPLOT_STUB_DIR)
+         << (useSession ? ", persistent session" : ", one process per plot") << endl;
+    cout << "points       series  mode   format  reps   p50 [ms]    p90 [ms]    p99 [ms]    Mpoints/s   MB/s" << endl;
+
+    for (size_t n = max<size_t>(minPoints, 1); n <= maxPoints; n *= 10) {
+        for (const string& seriesItem : seriesList) {
+            const size_t nSeries = max<size_t>(strtoull(seriesItem.c_str(), NULL, 10), 1);
+            const size_t perSeries = max<size_t>(n / nSeries, 1);
+
+            vector<vector<double>> x(nSeries, vector<double>(perSeries)), y(nSeries, vector<double>(perSeries));
+            for (size_t s = 0; s < nSeries; ++s) {
+                for (size_t i = 0; i < perSeries; ++i) {
+                    x[s][i] = i * 1e-3;
+                    y[s][i] = sin(x[s][i] + s) * exp(-x[s][i] * 1e-2);
+                }
+            }
+
+            for (const string& mode : modes) {
+                for (const string& formatName : formats) {
+                    const gnuplot_data_format format = (formatName == "binary") ? gnuplot_data_format::GNUPLOT_BINARY
+                                                                                : gnuplot_data_format::GNUPLOT_TEXT;
+                    const size_t nReps = (reps > 0) ? reps : max<size_t>(3, min<size_t>(50, 20000000 / n));
+
+                    // first plot warms up caches and page cache, it is not counted
+                    plotOnce(mode, format, session, x, y);
+
+                    vector<double> latency;
+                    size_t bytes = 0;
+                    for (size_t r = 0; r < nReps; ++r) {
+                        auto start = chrono::steady_clock::now();
+                        bytes = plotOnce(mode, format, session, x, y);
+                        latency.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+                    }
+                    sort(latency.begin(), latency.end());
+
+                    const double median = percentile(latency, 0.5);
+                    printf("%-12zu %-7zu %-6s %-7s %-6zu %-11.3f %-11.3f %-11.3f %-11.2f %.1f\n",
+                           perSeries * nSeries, nSeries, mode.c_str(), formatName.c_str(), nReps,
+                           median * 1e3, percentile(latency, 0.9) * 1e3, percentile(latency, 0.99) * 1e3,
+                           perSeries * nSeries / median * 1e-6, bytes / median * 1e-6);
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    remove("/tmp/simplePlot_bench.png");
+    remove("/tmp/simplePlot_bench.eps");
+
+}
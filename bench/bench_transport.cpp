@@ -0,0 +1,76 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Throughput of the text and binary data paths used by GnuplotDriver::plot.
+// usage: simplePlot_bench_transport [max number of points] [output file]
+
+#include "GnuplotData.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace std;
+
+static double writeSeconds(const string& fileName, const gnuplot_data_format& format,
+                           const vector<DataView>& columns, size_t& bytes) {
+
+    auto start = chrono::steady_clock::now();
+
+    ofstream out;
+    if (format == gnuplot_data_format::GNUPLOT_BINARY) {
+        out.open(fileName, ios::trunc | ios::binary);
+        writeBinaryData(out, columns);
+    } else {
+        out.open(fileName, ios::trunc);
+        writeTextData(out, columns);
+    }
+    bytes = out.tellp();
+    out.close();
+
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+}
+
+int main(int argc, char** argv){
+
+    size_t maxPoints = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+    string fileName = (argc > 2) ? argv[2] : "/tmp/simplePlot_bench_transport.dat";
+
+    cout << "points        format   time [s]   Mpoints/s   MB/s" << endl;
+
+    for (size_t n = 1000; n <= maxPoints; n *= 10) {
+
+        vector<double> x(n), y(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = i * 1e-3;
+            y[i] = sin(x[i]) * exp(-x[i] * 1e-2);
+        }
+
+        for (int f = 0; f < 2; ++f) {
+            gnuplot_data_format format = (f == 0) ? gnuplot_data_format::GNUPLOT_TEXT : gnuplot_data_format::GNUPLOT_BINARY;
+            size_t bytes = 0;
+            double t = writeSeconds(fileName, format, {x, y}, bytes);
+
+            printf("%-13zu %-8s %-10.4f %-11.2f %.1f\n", n, (f == 0) ? "text" : "binary",
+                   t, n / t * 1e-6, bytes / t * 1e-6);
+        }
+    }
+
+    remove(fileName.c_str());
+
+}
@@ -0,0 +1,73 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Zooming into a long signal: min/max decimation of windows of decreasing width, scanning the series
+// (decimateMinMax) and querying a MinMaxPyramid built once. Results are checked to be identical.
+// usage: simplePlot_bench_zoom [points] [pixels]
+
+#include "Decimation.h"
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace std;
+
+template<typename F>
+static double seconds(const F& f) {
+
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+}
+
+int main(int argc, char** argv){
+
+    const size_t n = (argc > 1) ? (size_t) strtod(argv[1], NULL) : 10000000;
+    const size_t pixels = (argc > 2) ? strtoull(argv[2], NULL, 10) : 640;
+
+    // a noisy signal with transients, sampled at 1 kHz
+    vector<double> t(n), v(n);
+    unsigned int seed = 1;
+    for (size_t i = 0; i < n; ++i) {
+        t[i] = i * 1e-3;
+        seed = seed * 1664525u + 1013904223u;
+        v[i] = sin(t[i]) + 0.1 * sin(37 * t[i]) + 1e-3 * (seed >> 16);
+    }
+
+    unique_ptr<MinMaxPyramid> pyramid;
+    const double build = seconds([&]() { pyramid.reset(new MinMaxPyramid(t, v)); });
+    printf("%zu points, pyramid built in %.3f s\n\n", n, build);
+
+    printf("%-14s %-12s %-12s %-10s %-8s\n", "window (s)", "scan ms", "pyramid ms", "points", "same");
+
+    const double length = t[n - 1];
+    for (double width = length; width >= 1e-2; width /= 10) {
+        const double xMin = 0.5 * (length - width);
+        const double xMax = xMin + width;
+
+        vector<double> sx, sy, px, py;
+        const double scan = seconds([&]() { decimateMinMax(t, v, xMin, xMax, false, pixels, sx, sy); });
+        const double query = seconds([&]() { pyramid->decimate(xMin, xMax, false, pixels, px, py); });
+
+        printf("%-14g %-12.3f %-12.3f %-10zu %-8s\n", width, scan * 1e3, query * 1e3, px.size(),
+               (sx == px && sy == py) ? "yes" : "NO");
+    }
+
+}
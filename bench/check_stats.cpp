@@ -0,0 +1,106 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Check of PlotStats on plots that end early: a driver plots nothing once, then plots something.
+// Every call must give its stats to the callback, and the stats of the second plot must count its own
+// data only, the same as the same plot made by a new driver. Data is sent in datablocks, so data written
+// by a plot that ends early would be seen in the bytes of the next one. gnuplot is the stub.
+// usage: simplePlot_check_stats
+
+#include "GnuplotDriver.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace std;
+
+#ifndef SIMPLEPLOT_STUB_DIR
+#define SIMPLEPLOT_STUB_DIR "bin/stub"
+#endif
+
+static GnuplotDriver* newDriver(const gnuplot_action_type& action, const string& fileName) {
+
+    GnuplotDriver* driver = new GnuplotDriver(gnuplot_axis_type::GNUPLOT_LINEAR, action, fileName);
+    driver->setDataTransport(gnuplot_data_transport::GNUPLOT_DATABLOCK);
+    return driver;
+
+}
+
+// true if nothing, then something, each give their stats, and those of something are its own
+static bool ownStats(const string& name, const gnuplot_action_type& action, const string& fileName,
+                     const function<void(GnuplotDriver&)>& nothing, const function<void(GnuplotDriver&)>& something) {
+
+    unique_ptr<GnuplotDriver> reference(newDriver(action, fileName));
+    reference->setStats(true);
+    something(*reference);
+    const PlotStats expected = reference->lastStats();
+
+    size_t calls = 0;
+    unique_ptr<GnuplotDriver> driver(newDriver(action, fileName));
+    driver->setStats(true, [&](const PlotStats&) { ++calls; });
+    nothing(*driver);
+    const bool nothingReported = (calls == 1);
+    something(*driver);
+    const PlotStats& stats = driver->lastStats();
+
+    const bool ok = nothingReported && calls == 2 && stats.dataBytes == expected.dataBytes &&
+                    stats.pointsWritten == expected.pointsWritten && expected.dataBytes > 0;
+    printf("%-34s %-6s %zu bytes, %zu points (expected %zu, %zu)\n", name.c_str(), ok ? "yes" : "NO",
+           stats.dataBytes, stats.pointsWritten, expected.dataBytes, expected.pointsWritten);
+    return ok;
+
+}
+
+int main(){
+
+    const char* path = getenv("PATH");
+    const string stubPath = string(SIMPLEPLOT_STUB_DIR) + ":" + (path ? path : "");
+    setenv("PATH", stubPath.c_str(), 1);
+
+    const string base = "/tmp/simplePlot_check_stats_" + to_string(getpid());
+    const string png = base + ".png";
+    const string emptyFile = base + ".txt";
+    ofstream(emptyFile) << "# header only\n";
+
+    vector<double> x = {1, 2, 3, 4}, y = {2, 3, 5, 7};
+    vector<double> none;
+    vector<double> nans(4, NAN);
+
+    auto plotXY = [&](GnuplotDriver& d) { d.plot(x, y); };
+
+    bool ok = true;
+    ok &= ownStats("empty series", gnuplot_action_type::GNUPLOT_SAVE, png,
+                   [&](GnuplotDriver& d) { d.plot(none, none); }, plotXY);
+    ok &= ownStats("file with no rows", gnuplot_action_type::GNUPLOT_SAVE, png,
+                   [&](GnuplotDriver& d) { d.plotFile(emptyFile, FileLayout(), 0, {1}, [](double v) { return v; }); }, plotXY);
+    ok &= ownStats("density with no plottable point", gnuplot_action_type::GNUPLOT_SAVE, png,
+                   [&](GnuplotDriver& d) { d.plotDensity(DataView(nans), DataView(nans)); }, plotXY);
+    ok &= ownStats("animation with no frame", gnuplot_action_type::GNUPLOT_VIDEO, png,
+                   [&](GnuplotDriver& d) { d.playAnimation(DataView(x), 0); },
+                   [&](GnuplotDriver& d) { d.plot(x, y); d.playAnimation(DataView(x), 0); });
+
+    unlink(emptyFile.c_str());
+    unlink(png.c_str());
+
+    cout << (ok ? "stats of every plot are its own" : "FAILED") << endl;
+    return ok ? 0 : 1;
+
+}
@@ -0,0 +1,236 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Stress test of concurrent drivers: many processes, each with many threads, create drivers and export plots
+// at the same time, with every data transport and format, with and without a shared session.
+// Every plot has its own data; gnuplot is replaced by the stub in echo mode (see stub_gnuplot.cpp), which writes
+// to the exported file the data it read, so every output is checked against the data of its plot.
+// At the end the temporary directory of every process must be empty.
+//
+// usage: simplePlot_stress [options]
+//   --processes N       processes plotting at once, default 2
+//   --threads N         threads per process, default 8
+//   --plots N           plots per thread, default 50
+//   --real-gnuplot      uses gnuplot from PATH: outputs are only checked to be png files
+
+#include "GnuplotDriver.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+#ifndef SIMPLEPLOT_STUB_DIR
+#define SIMPLEPLOT_STUB_DIR "bin/stub"
+#endif
+
+static string readAll(const string& fileName) {
+
+    ifstream in(fileName, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+
+}
+
+// true if the data echoed by the stub is exactly x, y
+static bool sameData(const string& echoed, const bool& binary, const vector<double>& x, const vector<double>& y) {
+
+    vector<double> values;
+    if (binary) {
+        values.resize(echoed.size() / sizeof(double));
+        memcpy(values.data(), echoed.data(), values.size() * sizeof(double));
+    } else {
+        const char* p = echoed.c_str();
+        char* end;
+        while (true) {
+            const double v = strtod(p, &end);
+            if (end == p) break;
+            values.push_back(v);
+            p = end;
+        }
+    }
+
+    if (values.size() != 2 * x.size()) return false;
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (values[2*i] != x[i] || values[2*i+1] != y[i]) return false;
+    }
+    return true;
+
+}
+
+// number of entries of dir, . and .. excluded
+static size_t entries(const string& dir) {
+
+    DIR* d = opendir(dir.c_str());
+    if (!d) return 0;
+    size_t n = 0;
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL) {
+        if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0) ++n;
+    }
+    closedir(d);
+    return n;
+
+}
+
+// plots of process p, returns the number of failed checks
+static size_t runProcess(const size_t& p, const size_t& nThreads, const size_t& nPlots, const bool& realGnuplot,
+                         const string& outDir) {
+
+    atomic<size_t> failures(0);
+
+    auto work = [&](const size_t t) {
+        for (size_t k = 0; k < nPlots; ++k) {
+            const size_t id = (p * nThreads + t) * nPlots + k;
+            const string fileName = outDir + "/plot_" + to_string(id) + ".png";
+
+            // data of this plot only: a mix up between drivers shows as wrong values
+            const size_t n = 16 + id % 50;
+            vector<double> x(n), y(n);
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = (double) i;
+                y[i] = id * 1000.0 + i + 0.25;
+            }
+
+            // a new driver for every plot, so that drivers are also created and destroyed at once
+            GnuplotDriver driver(gnuplot_axis_type::GNUPLOT_LINEAR, gnuplot_action_type::GNUPLOT_SAVE, fileName);
+            const gnuplot_data_transport transports[3] = {gnuplot_data_transport::GNUPLOT_FILE,
+                                                          gnuplot_data_transport::GNUPLOT_MEMFD,
+                                                          gnuplot_data_transport::GNUPLOT_DATABLOCK};
+            const gnuplot_data_transport transport = transports[(t + k) % 3];
+            const bool binary = (k % 2 == 1) && transport != gnuplot_data_transport::GNUPLOT_DATABLOCK;
+            driver.setDataTransport(transport);
+            driver.setDataFormat(binary ? gnuplot_data_format::GNUPLOT_BINARY : gnuplot_data_format::GNUPLOT_TEXT);
+            if (k % 4 == 3) driver.setSession(GnuplotSession::processSession());
+            driver.setTitle("plot " + to_string(id));
+            driver.setStats(true);
+
+            bool ok;
+            try {
+                driver.plot(x, y);
+                const string output = readAll(fileName);
+                ok = (driver.lastStats().status == 0) &&
+                     (realGnuplot ? output.compare(0, 4, "\x89PNG") == 0 : sameData(output, binary, x, y));
+            } catch (std::exception&) {
+                ok = false;
+            }
+
+            if (!ok) {
+                ++failures;
+                cout << "[stress] process " << p << " thread " << t << " plot " << k << ": wrong output in " << fileName << endl;
+            } else {
+                unlink(fileName.c_str());
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t t = 0; t < nThreads; ++t) workers.push_back(thread(work, t));
+    for (size_t t = 0; t < nThreads; ++t) workers[t].join();
+
+    return failures;
+
+}
+
+int main(int argc, char** argv){
+
+    size_t nProcesses = 2, nThreads = 8, nPlots = 50;
+    bool realGnuplot = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--processes" && hasValue) nProcesses = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--threads" && hasValue) nThreads = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--plots" && hasValue) nPlots = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--real-gnuplot") realGnuplot = true;
+        else {
+            cout << "usage: simplePlot_stress [--processes N] [--threads N] [--plots N] [--real-gnuplot]" << endl;
+            return 1;
+        }
+    }
+    if (nProcesses == 0) nProcesses = 1;
+    if (nThreads == 0) nThreads = 1;
+
+    if (!realGnuplot) {
+        const char* path = getenv("PATH");
+        const string stubPath = string(SIMPLEPLOT_STUB_DIR) + ":" + (path ? path : "");
+        setenv("PATH", stubPath.c_str(), 1);
+        setenv("SIMPLEPLOT_STUB_ECHO", "1", 1);
+    }
+
+    // outputs, and the temporary directories of the drivers, in a directory of our own
+    const char* tmpDir = getenv("TMPDIR");
+    string root = string((tmpDir && *tmpDir) ? tmpDir : "/tmp") + "/simplePlot_stress_XXXXXX";
+    if (!mkdtemp(&root[0])) {
+        cout << "could not create a directory for the outputs" << endl;
+        return 1;
+    }
+    const string outDir = root + "/out";
+    const string driversDir = root + "/tmp";
+    mkdir(outDir.c_str(), 0700);
+    mkdir(driversDir.c_str(), 0700);
+    setenv("TMPDIR", driversDir.c_str(), 1);
+
+    // processes are forked before any thread is started
+    vector<pid_t> children;
+    size_t process = 0;
+    for (size_t p = 1; p < nProcesses; ++p) {
+        const pid_t child = fork();
+        if (child == 0) {
+            process = p;
+            children.clear();
+            break;
+        }
+        if (child > 0) children.push_back(child);
+    }
+
+    size_t failures = runProcess(process, nThreads, nPlots, realGnuplot, outDir);
+    if (process != 0) _exit(failures > 0 ? 1 : 0);
+
+    for (size_t c = 0; c < children.size(); ++c) {
+        int status = 0;
+        while (waitpid(children[c], &status, 0) < 0 && errno == EINTR);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failures;
+    }
+
+    // every driver removed its files and its directory
+    const size_t left = entries(driversDir);
+    if (left > 0) cout << "[stress] " << left << " temporary files or directories left in " << driversDir << endl;
+
+    const size_t total = nProcesses * nThreads * nPlots;
+    cout << total << " plots by " << nProcesses << " processes x " << nThreads << " threads: "
+         << (failures == 0 && left == 0 ? "all outputs correct" : "FAILED") << endl;
+
+    if (failures == 0 && left == 0) {
+        rmdir(outDir.c_str());
+        rmdir(driversDir.c_str());
+        rmdir(root.c_str());
+    }
+
+    return (failures == 0 && left == 0) ? 0 : 1;
+
+}
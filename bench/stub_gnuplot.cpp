@@ -0,0 +1,180 @@
+//============================================================
+//
+//      Type:        simplePlot benchmark file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// Minimal stand-in for gnuplot, built as bin/stub/gnuplot: it lets the library overhead be measured without
+// rendering. The script is read from the file given as argument, or from stdin as in a GnuplotSession.
+// Data files named in plot commands are read once per command, so data reaches the "plotting" process.
+// Lines print "text" are answered on stdout, as gnuplot does after set print "-", so session markers work.
+// exit or quit end the stub, as in gnuplot; the exit status is always 0. cd 'dir' changes directory, as in gnuplot.
+// If SIMPLEPLOT_STUB_ECHO is set, the data read by every plot (files, then datablocks in order of use) is written to the file
+// set with set output, instead of an image, so that tests can check what reached gnuplot.
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <string>
+#include <set>
+#include <map>
+#include <unistd.h>
+
+using namespace std;
+
+// reads fileName, appending it to echo if not null
+static void readFile(const string& fileName, string* echo) {
+
+    static char buffer[1 << 20];
+
+    FILE* f = fopen(fileName.c_str(), "rb");
+    if (!f) return;
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        if (echo) echo->append(buffer, n);
+    }
+    fclose(f);
+
+}
+
+// reads every quoted file of a plot command, once
+static void readPlotData(const string& line, string* echo) {
+
+    set<string> files;
+    size_t pos = 0;
+    while ((pos = line.find('"', pos)) != string::npos) {
+        const size_t end = line.find('"', pos + 1);
+        if (end == string::npos) break;
+        files.insert(line.substr(pos + 1, end - pos - 1));
+        pos = end + 1;
+    }
+
+    for (set<string>::const_iterator f = files.begin(); f != files.end(); ++f) readFile(*f, echo);
+
+}
+
+// file name of a set output "name" line, empty if line is something else
+static string outputName(const string& line) {
+
+    if (line.compare(0, 12, "set output \"") != 0) return "";
+    const size_t end = line.rfind('"');
+    return (end > 12) ? line.substr(12, end - 12) : "";
+
+}
+
+// directory of a cd 'dir' line, quotes written twice in it being one, empty if line is something else
+static string cdDirectory(const string& line) {
+
+    if (line.compare(0, 4, "cd '") != 0) return "";
+    const size_t end = line.rfind('\'');
+    string dir;
+    for (size_t k = 4; k < end; ++k) {
+        dir += line[k];
+        if (line[k] == '\'' && k + 1 < end && line[k + 1] == '\'') ++k;
+    }
+    return dir;
+
+}
+
+// datablocks named in line, each once, in order of first use
+static string usedBlocks(const string& line, const map<string, string>& blocks) {
+
+    string data;
+    set<string> used;
+    size_t pos = 0;
+    while ((pos = line.find('$', pos)) != string::npos) {
+        size_t end = pos + 1;
+        while (end < line.size() && (isalnum((unsigned char) line[end]) || line[end] == '_')) ++end;
+        const string name = line.substr(pos, end - pos);
+        map<string, string>::const_iterator b = blocks.find(name);
+        if (b != blocks.end() && used.insert(name).second) data += b->second;
+        pos = end;
+    }
+    return data;
+
+}
+
+static bool isPlotCommand(const string& line) {
+
+    const size_t first = line.find_first_not_of(" \t");
+    if (first == string::npos) return false;
+    return line.compare(first, 5, "plot ") == 0 || line.compare(first, 6, "splot ") == 0;
+
+}
+
+int main(int argc, char** argv) {
+
+    FILE* in = stdin;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--persist") == 0 || strcmp(argv[i], "-persist") == 0) continue;
+        in = fopen(argv[i], "r");
+        if (!in) return 1;
+    }
+
+    const bool echo = getenv("SIMPLEPLOT_STUB_ECHO") != NULL;
+    string output;              // file set with set output, if echo
+    map<string, string> blocks; // datablocks by name, if echo
+    string block;               // name of the datablock being read
+    bool inBlock = false;
+
+    string line;
+    char chunk[1 << 16];
+
+    while (fgets(chunk, sizeof(chunk), in)) {
+        line += chunk;
+        if (line.empty() || line[line.size() - 1] != '\n') {
+            if (!feof(in)) continue;
+        } else {
+            line.erase(line.size() - 1);
+        }
+
+        if (echo && inBlock) {
+            if (line == "EOD") inBlock = false;
+            else blocks[block] += line + "\n";
+        } else if (echo && line.find("<< EOD") != string::npos) {
+            inBlock = true;
+            block = line.substr(0, line.find(' '));
+            blocks[block].clear();
+        } else if (echo && line.compare(0, 9, "undefine ") == 0) {
+            blocks.erase(line.substr(9));
+        } else if (echo && !outputName(line).empty()) {
+            output = outputName(line);
+            FILE* f = fopen(output.c_str(), "wb");
+            if (f) fclose(f);
+        } else if (!cdDirectory(line).empty()) {
+            if (chdir(cdDirectory(line).c_str()) != 0) fprintf(stderr, "stub: cannot cd to %s\n", cdDirectory(line).c_str());
+        } else if (line.compare(0, 7, "print \"") == 0) {
+            const size_t end = line.rfind('"');
+            printf("%s\n", line.substr(7, end - 7).c_str());
+            fflush(stdout);
+        } else if (line == "exit" || line == "quit") {
+            break;
+        } else if (isPlotCommand(line)) {
+            string data;
+            readPlotData(line, echo ? &data : NULL);
+            if (echo && !output.empty()) {
+                data += usedBlocks(line, blocks);
+                FILE* f = fopen(output.c_str(), "ab");
+                if (f) {
+                    fwrite(data.data(), 1, data.size(), f);
+                    fclose(f);
+                }
+            }
+        }
+
+        line.clear();
+    }
+
+    return 0;
+
+}
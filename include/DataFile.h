@@ -0,0 +1,131 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_DATAFILE_H
+#define GNUPLOT_DATAFILE_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+#include "GnuplotData.h"
+#include "DataView.h"
+
+using namespace std;
+
+/**
+ * description of a data file written by another program, see GnuplotDriver::plotFile.
+ * Text files hold one row per line, comment lines (#) and blank lines are ignored.
+ * Binary files hold records of `columns` values of type dtype, one record per row.
+ */
+struct FileLayout {
+
+    gnuplot_data_format format = gnuplot_data_format::GNUPLOT_TEXT;
+    char separator = 0;             /**< \brief text only: column separator, i.e. ',' for csv. 0 for blanks **/
+    size_t skip = 0;                /**< \brief lines (text) or bytes (binary) of header to be skipped **/
+    gnuplot_dtype dtype = gnuplot_dtype::GNUPLOT_FLOAT64;   /**< \brief binary only: type of every value **/
+    size_t columns = 2;             /**< \brief binary only: values per record **/
+    bool littleEndian = true;       /**< \brief binary only: byte order of values **/
+    size_t stride = 1;              /**< \brief only one row every stride is used **/
+
+};
+
+/**
+ * Class MappedFile maps a whole file read-only in memory.
+ */
+class MappedFile {
+
+private:
+
+    const char* bytes;
+    size_t length;
+
+public:
+    explicit MappedFile(const string& fileName);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+    /**
+     * hints the operating system that the file is going to be read in order.
+     */
+    void adviseSequential() const;
+
+};
+
+/**
+ * Class DataFile reads the columns of a data file described by a FileLayout, without loading it:
+ * the file is mapped and rows are decoded one at a time.
+ */
+class DataFile {
+
+private:
+
+    string fileName;
+    FileLayout layout;
+    MappedFile file;
+
+    void forEachTextRow(const vector<size_t>& columns, const function<void(const double*)>& f) const;
+    void forEachBinaryRow(const vector<size_t>& columns, const function<void(const double*)>& f) const;
+
+    /**
+     * start of the rows of a text file, after the header lines.
+     */
+    const char* textBegin() const;
+
+public:
+    DataFile(const string& fileName, const FileLayout& layout);
+
+    /**
+     * number of records of a binary file, stride excluded.
+     */
+    size_t records() const;
+
+    /**
+     * calls f for every row used (one every layout.stride) with the values of columns, in order.
+     * Columns start from 0; text fields that are missing or not numbers are read as nan.
+     */
+    void forEachRow(const vector<size_t>& columns, const function<void(const double*)>& f) const;
+
+    /**
+     * reads in values[k] column columns[k] of every row used, as forEachRow, the file being split in chunks
+     * parsed in parallel. Numbers in plain decimal notation are parsed without strtod; values are the same.
+     * @param threads threads parsing the file, 0 for one per core. Small files are parsed by fewer threads
+     * @return number of rows read
+     */
+    size_t readColumns(const vector<size_t>& columns, vector<vector<double>>& values, const size_t& threads = 0) const;
+
+    size_t bytes() const { return file.size(); }     /**< \brief size of the file **/
+
+    /**
+     * returns the gnuplot modifiers reading the file as described by layout, i.e.
+     * ` binary record=(1000) skip=16 format="%float32%float32" endian=little every 2`.
+     * The separator of text files has to be set apart, see separatorCommand.
+     */
+    string gnuplotSpec() const;
+
+    /**
+     * returns the gnuplot command setting the column separator of text files, empty if blanks are used.
+     */
+    string separatorCommand() const;
+
+};
+
+
+#endif //GNUPLOT_DATAFILE_H
@@ -0,0 +1,91 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_DATAKERNELS_H
+#define GNUPLOT_DATAKERNELS_H
+
+#include <cstddef>
+#include <limits>
+#include "DataView.h"
+
+using namespace std;
+
+/**
+ * Kernels scanning whole series in one pass, used for ranges and to drop points gnuplot cannot plot.
+ * Every kernel has an AVX2, an SSE2 and a scalar version: the best one supported by the cpu is selected
+ * the first time a kernel is called.
+ */
+
+enum class gnuplot_simd{
+
+    GNUPLOT_SCALAR,
+    GNUPLOT_SSE2,
+    GNUPLOT_AVX2
+
+};
+
+/**
+ * range of the values of a series that can be plotted.
+ */
+struct ValueRange {
+
+    double min = numeric_limits<double>::max();
+    double max = -numeric_limits<double>::max();
+    size_t count = 0;               /**< \brief number of values in the range, min > max if 0 **/
+
+    void merge(const ValueRange& other) {
+        if (other.min < min) min = other.min;
+        if (other.max > max) max = other.max;
+        count += other.count;
+    }
+
+};
+
+/**
+ * instruction set used by the kernels.
+ */
+gnuplot_simd simdLevel();
+
+/**
+ * uses level, or the best one supported below it, instead of the best one. Meant for benchmarks.
+ */
+void setSimdLevel(const gnuplot_simd& level);
+
+/**
+ * range of the finite values, only the positive ones if positiveOnly (i.e. for a log axis).
+ */
+ValueRange valueRange(const double* values, const size_t& n, const bool& positiveOnly = false);
+
+/**
+ * as valueRange, for values of any type: contiguous doubles are scanned in place, others a chunk at a time.
+ */
+ValueRange valueRange(const DataView& values, const bool& positiveOnly = false);
+
+/**
+ * index of the first point that cannot be plotted: x or y not finite, or not positive on a log axis.
+ * @return n if every point can be plotted
+ */
+size_t firstUnplottable(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY);
+
+/**
+ * copies in outX, outY the points that can be plotted (see firstUnplottable), in order.
+ * outX and outY must hold n values.
+ * @return number of points copied
+ */
+size_t keepPlottable(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY,
+                     double* outX, double* outY);
+
+
+#endif //GNUPLOT_DATAKERNELS_H
@@ -0,0 +1,145 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_DATAVIEW_H
+#define GNUPLOT_DATAVIEW_H
+
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+using namespace std;
+
+enum class gnuplot_dtype{
+
+    GNUPLOT_FLOAT64,
+    GNUPLOT_FLOAT32,
+    GNUPLOT_INT64,
+    GNUPLOT_INT32,
+    GNUPLOT_INT16,
+    GNUPLOT_UINT8,
+    GNUPLOT_INT8,
+    GNUPLOT_UINT16,
+    GNUPLOT_UINT32,
+    GNUPLOT_UINT64
+
+};
+
+/**
+ * size in bytes of a value of type dtype.
+ */
+size_t dtypeSize(const gnuplot_dtype& dtype);
+
+/**
+ * Class DataView points to n values of any arithmetic type, stored one every stride elements,
+ * so that data can be plotted where it is: vectors, raw pointers, matrix columns, fields of records.
+ * Nothing is copied: the data must outlive the view, and a plot reads it during the call only.
+ * Values are read as doubles; contiguous doubles are used in place, other types are converted
+ * a chunk at a time (see DataView::read).
+ *
+ * i.e. DataView(samples, n)                    float* from a solver
+ *      DataView(m.data() + j, m.rows(), m.cols()) column j of a row-major matrix
+ *      DataView::column(particles, n, &Particle::energy) one field of an array of structs
+ */
+class DataView {
+
+private:
+
+    const char* base;
+    size_t n;
+    size_t stride;              /**< \brief bytes from a value to the next **/
+    gnuplot_dtype type;
+
+    template<typename T>
+    static gnuplot_dtype typeOf() {
+        static_assert(is_arithmetic<T>::value, "DataView needs arithmetic values");
+        static_assert(!is_floating_point<T>::value || sizeof(T) == 4 || sizeof(T) == 8, "DataView supports float and double only");
+        if (is_floating_point<T>::value) return sizeof(T) == 4 ? gnuplot_dtype::GNUPLOT_FLOAT32 : gnuplot_dtype::GNUPLOT_FLOAT64;
+        switch (sizeof(T)) {
+        case 1: return is_signed<T>::value ? gnuplot_dtype::GNUPLOT_INT8 : gnuplot_dtype::GNUPLOT_UINT8;
+        case 2: return is_signed<T>::value ? gnuplot_dtype::GNUPLOT_INT16 : gnuplot_dtype::GNUPLOT_UINT16;
+        case 4: return is_signed<T>::value ? gnuplot_dtype::GNUPLOT_INT32 : gnuplot_dtype::GNUPLOT_UINT32;
+        default: return is_signed<T>::value ? gnuplot_dtype::GNUPLOT_INT64 : gnuplot_dtype::GNUPLOT_UINT64;
+        }
+    }
+
+    double convert(const size_t& i) const;
+
+public:
+    static const size_t chunkSize = 1024;   /**< \brief values converted at once by users of DataView::read **/
+
+    DataView() : base(nullptr), n(0), stride(sizeof(double)), type(gnuplot_dtype::GNUPLOT_FLOAT64) {}
+
+    DataView(const vector<double>& v)
+        : base(reinterpret_cast<const char*>(v.data())), n(v.size()), stride(sizeof(double)), type(gnuplot_dtype::GNUPLOT_FLOAT64) {}
+
+    template<typename T>
+    DataView(const vector<T>& v)
+        : base(reinterpret_cast<const char*>(v.data())), n(v.size()), stride(sizeof(T)), type(typeOf<T>()) {}
+
+    /**
+     * @param stride distance between two values, in elements of T
+     */
+    template<typename T>
+    DataView(const T* data, const size_t& n, const size_t& stride = 1)
+        : base(reinterpret_cast<const char*>(data)), n(n), stride(stride * sizeof(T)), type(typeOf<T>()) {}
+
+    /**
+     * field member of n records, i.e. one column of interleaved data.
+     */
+    template<typename Record, typename T>
+    static DataView column(const Record* records, const size_t& n, T Record::* member) {
+        DataView view(&(records->*member), n);
+        view.stride = sizeof(Record);
+        return view;
+    }
+
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    gnuplot_dtype dtype() const { return type; }
+
+    /**
+     * the values, if they are contiguous doubles. Null otherwise.
+     */
+    const double* doubles() const {
+        return (type == gnuplot_dtype::GNUPLOT_FLOAT64 && stride == sizeof(double)) ? reinterpret_cast<const double*>(base) : nullptr;
+    }
+
+    double operator[](const size_t& i) const {
+        if (type == gnuplot_dtype::GNUPLOT_FLOAT64) {
+            // memcpy: fields of packed records may not be aligned
+            double v;
+            memcpy(&v, base + i * stride, sizeof(double));
+            return v;
+        }
+        return convert(i);
+    }
+
+    /**
+     * values first to first+count-1 as doubles: in place if they are contiguous doubles,
+     * otherwise converted in buffer, that must hold count values.
+     */
+    const double* read(const size_t& first, const size_t& count, double* buffer) const;
+
+    /**
+     * writes every value in out, that must hold size() values.
+     */
+    void copyTo(double* out) const;
+
+};
+
+
+#endif //GNUPLOT_DATAVIEW_H
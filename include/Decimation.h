@@ -0,0 +1,165 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_DECIMATION_H
+#define GNUPLOT_DECIMATION_H
+
+#include <vector>
+#include <cstddef>
+#include "DataView.h"
+#include "DataKernels.h"
+
+using namespace std;
+
+enum class gnuplot_decimation_type{
+
+    GNUPLOT_NO_DECIMATION,
+    GNUPLOT_MINMAX,         /**< \brief first, min, max and last point of every pixel column: no visible difference **/
+    GNUPLOT_LTTB            /**< \brief Largest-Triangle-Three-Buckets: fewer points, shape preserving **/
+
+};
+
+/**
+ * Functions reducing a series to the points that can be seen on a plot nColumns pixels wide,
+ * where the x axis spans [xMin, xMax] (in log scale if logX is true).
+ * x must be sorted in non decreasing order: if it is not, the series is copied as it is and false is returned.
+ * Points outside [xMin, xMax] are dropped, except the two neighbours of the range, so lines still
+ * enter and leave the plot with the right slope. With logX non positive x are dropped.
+ */
+
+bool decimateMinMax(const DataView& x, const DataView& y,
+                    const double& xMin, const double& xMax, const bool& logX, const size_t& nColumns,
+                    vector<double>& outX, vector<double>& outY);
+
+/**
+ * Class MinMaxStream does what decimateMinMax does on a series given one point at a time, in order of x,
+ * holding only the pixel column being filled. Used for series too large to be held in memory.
+ */
+class MinMaxStream {
+
+private:
+
+    struct Point {
+        size_t n;               /**< \brief position in the series **/
+        double x, y;
+    };
+
+    double xMin, xMax;
+    bool logX;
+    size_t nColumns;
+    double x0, scale;
+
+    long column;                /**< \brief pixel column being filled, -1 if none **/
+    Point first, last, lowest, highest;
+    size_t count;
+    bool hasBefore;             /**< \brief true if before holds the last point before the range, not written yet **/
+    Point before;
+    bool afterWritten;          /**< \brief true if the first point after the range has been written **/
+    bool sorted;
+    double previousX;
+
+    vector<double> outX, outY;
+
+    void push(const double& x, const double& y);
+    void flush();
+
+public:
+    MinMaxStream(const double& xMin, const double& xMax, const bool& logX, const size_t& nColumns);
+
+    void add(const double& x, const double& y);
+
+    /**
+     * moves the points kept in x, y.
+     * @return false if points were not given in order of x: the result is then only approximate
+     */
+    bool finish(vector<double>& x, vector<double>& y);
+
+};
+
+/**
+ * Class MinMaxPyramid is a level of detail index of a series sorted by x, built once and queried for any
+ * x range: MinMaxPyramid::decimate gives the points decimateMinMax would keep in O(nColumns log n) time,
+ * whatever the size of the series, so zooming into a huge series costs the same as plotting a small one.
+ * Level 1 holds min and max of y in blocks of blockSize points, every level above merges fanOut blocks of
+ * the one below. The index takes about 40 bytes every blockSize points; x and y are not copied and must
+ * outlive the pyramid.
+ */
+class MinMaxPyramid {
+
+private:
+
+    struct Node {
+        double min, max;
+        size_t iMin, iMax;      /**< \brief position of first min and first max in the series, npos if every y is nan **/
+    };
+
+    DataView x, y;
+    bool sorted;
+    vector<vector<Node>> levels; /**< \brief levels[k] covers the series in blocks of blockSize * fanOut^k points **/
+
+    static Node emptyNode();
+    static void merge(const double& value, const size_t& i, Node& node);  /**< \brief adds point i to node **/
+    static void merge(const Node& other, Node& node);                     /**< \brief lower min and higher max, the first if equal **/
+
+    /**
+     * merges in node the min and max of y over [first, last).
+     */
+    void scan(const size_t& first, const size_t& last, Node& node) const;
+
+    /**
+     * min and max of y over [first, last), the first ones if repeated.
+     */
+    Node extremes(size_t first, size_t last) const;
+
+public:
+    static const size_t blockSize = 64;
+    static const size_t fanOut = 8;
+    static const size_t npos = (size_t) -1;
+
+    /**
+     * builds the index in one pass over the series, and checks x is sorted.
+     */
+    MinMaxPyramid(const DataView& x, const DataView& y);
+
+    bool isSorted() const { return sorted; }
+    size_t size() const { return x.size(); }
+    const DataView& xValues() const { return x; }
+    const DataView& yValues() const { return y; }
+
+    /**
+     * range of x, only the positive values if positiveOnly, found in O(log n). Meaningful if x is sorted.
+     */
+    ValueRange xRange(const bool& positiveOnly = false) const;
+
+    /**
+     * as decimateMinMax(x, y, xMin, xMax, logX, nColumns, outX, outY), only reading the pixel column
+     * bounds and the pyramid nodes. Here nan y are never a min or a max: columns of nan keep first and last point.
+     * @return false if x is not sorted: the series is then copied as it is
+     */
+    bool decimate(const double& xMin, const double& xMax, const bool& logX, const size_t& nColumns,
+                  vector<double>& outX, vector<double>& outY) const;
+
+};
+
+/**
+ * as decimateMinMax, keeps nPoints using Largest-Triangle-Three-Buckets.
+ * Triangle areas are evaluated in plot coordinates, i.e. in log scale if logX or logY are true.
+ */
+bool decimateLTTB(const DataView& x, const DataView& y,
+                  const double& xMin, const double& xMax, const bool& logX, const bool& logY, const size_t& nPoints,
+                  vector<double>& outX, vector<double>& outY);
+
+
+#endif //GNUPLOT_DECIMATION_H
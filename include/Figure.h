@@ -0,0 +1,95 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_FIGURE_H
+#define GNUPLOT_FIGURE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include "GnuplotDriver.h"
+
+using namespace std;
+
+/**
+ * Class Figure composes rows x cols panels in one page, rendered by a single gnuplot run
+ * ("set multiplot layout"). Every panel is set up as a GnuplotDriver (title, ranges, axis type,
+ * labels, legend, plot options, decimation) through Figure::panel, then data is given with Figure::plot.
+ * Data of all the panels is written in one pass, in one data file (or datablock, or memory file).
+ *
+ * Figure fig(2, 2, gnuplot_action_type::GNUPLOT_SAVE, "page.png");
+ * fig.panel(0, 0).setTitle("pressure");
+ * fig.plot(0, 0, x, p);
+ * fig.render();
+ */
+class Figure {
+
+private:
+
+    size_t rows;
+    size_t cols;
+    string title;
+    size_t width;               /**< \brief page size in pixels, 0 for gnuplot default **/
+    size_t height;
+
+    GnuplotDriver page;         /**< \brief output, data transport and session of the whole page **/
+    vector<unique_ptr<GnuplotDriver>> panels; /**< \brief settings of every panel, row by row **/
+    vector<vector<vector<double>>> panelX; /**< \brief series of every panel **/
+    vector<vector<vector<double>>> panelY;
+
+    size_t index(const size_t& row, const size_t& col) const;
+
+    /**
+     * returns lines needed for saving the page: terminal, with page size if set, and output file.
+     */
+    string write_action_save() const;
+
+public:
+    Figure(const size_t& rows, const size_t& cols, gnuplot_action_type action_type = gnuplot_action_type::GNUPLOT_PLOT,
+           string fileName = "figure.png", gnuplot_save_type format = gnuplot_save_type::GNUPLOT_PNG);
+
+    /**
+     * driver holding the settings of panel (row, col). Only its settings are used: data is given with Figure::plot.
+     */
+    GnuplotDriver& panel(const size_t& row, const size_t& col);
+
+    // data of panel (row, col), replacing the one previously set. Series i is x[i], y[i]
+    void plot(const size_t& row, const size_t& col, const vector<double>& x, const vector<double>& y);
+    void plot(const size_t& row, const size_t& col, const DataView& x, const DataView& y);
+    void plot(const size_t& row, const size_t& col, const vector<vector<double>>& x, const vector<vector<double>>& y);
+
+    void clear();                                         /**< \brief removes data of every panel **/
+
+    void setTitle(const string& str);                     /**< \brief title of the whole page **/
+    void setSize(const size_t& w, const size_t& h);       /**< \brief page size in pixels (eps: hundredths of inch) **/
+    void setSaveName(const string& fileName);
+    void setDataFormat(const gnuplot_data_format& format);
+    void setDataTransport(const gnuplot_data_transport& transport);
+    void setPrecision(const int& digits);                 /**< \brief significant digits of text data, see GnuplotDriver::setPrecision **/
+    void setSession(const shared_ptr<GnuplotSession>& s = nullptr);
+    void setRenderCache(const shared_ptr<RenderCache>& cache);  /**< \brief see GnuplotDriver::setRenderCache **/
+    void setStats(const bool& enabled, const function<void(const PlotStats&)>& callback = nullptr); /**< \brief see GnuplotDriver::setStats **/
+    const PlotStats& lastStats() const;
+
+    /**
+     * plots (or saves) the page. Panels without data are left blank.
+     * @return exit status of gnuplot
+     */
+    int render();
+
+};
+
+
+#endif //GNUPLOT_FIGURE_H
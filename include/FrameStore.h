@@ -0,0 +1,82 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_FRAMESTORE_H
+#define GNUPLOT_FRAMESTORE_H
+
+#include <vector>
+#include <cstddef>
+#include "DataView.h"
+
+using namespace std;
+
+/**
+ * Class FrameStore holds the frames of an animation (GNUPLOT_VIDEO mode).
+ * Every frame has the same number of curves and points and is stored contiguously, curve after curve:
+ * frame(f)[k * points() + i] is point i of curve k. Frames are kept in memory until they take more than
+ * spillThreshold bytes, then they are moved to a memory mapped temporary file, so RAM usage is bounded
+ * by the operating system page cache.
+ */
+class FrameStore {
+
+private:
+
+    size_t nCurves;
+    size_t nPoints;
+    size_t nFrames;
+
+    size_t spillThreshold;          /**< \brief bytes kept in memory before spilling to file **/
+    vector<double> memory;          /**< \brief frames, until spilled **/
+
+    int fd;                         /**< \brief spill file, already unlinked. -1 if not spilled **/
+    double* mapped;                 /**< \brief mapping of the spill file **/
+    size_t mappedFrames;            /**< \brief frames that fit in the spill file **/
+
+    double* reserveFrame();
+    void spill();
+    void grow(const size_t& frames);
+    void release();
+
+public:
+    explicit FrameStore(const size_t& spillThreshold = 256u << 20);
+    ~FrameStore();
+
+    FrameStore(const FrameStore&) = delete;
+    FrameStore& operator=(const FrameStore&) = delete;
+
+    /**
+     * appends a frame: curve k is y[k]. The first frame sets number of curves and points.
+     */
+    void push(const vector<DataView>& y);
+
+    void clear();
+    void setSpillThreshold(const size_t& bytes);
+
+    size_t frames() const { return nFrames; }
+    size_t curves() const { return nCurves; }
+    size_t points() const { return nPoints; }
+    bool spilled() const { return mapped != nullptr; }
+
+    const double* frame(const size_t& f) const;
+
+    /**
+     * hints the operating system that frames are going to be read in order.
+     */
+    void adviseSequential() const;
+
+};
+
+
+#endif //GNUPLOT_FRAMESTORE_H
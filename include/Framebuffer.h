@@ -0,0 +1,77 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_FRAMEBUFFER_H
+#define GNUPLOT_FRAMEBUFFER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Class Framebuffer is an opaque RGBA image drawn by RasterBackend.
+ * Colors are 0xRRGGBB. Lines are antialiased (Xiaolin Wu) and clipped to the clip rectangle;
+ * text uses a built-in 5x7 pixel font, printable ASCII only, scaled by an integer factor.
+ */
+class Framebuffer {
+
+private:
+
+    size_t w, h;
+    vector<unsigned char> pixels;
+    int clipX0, clipY0, clipX1, clipY1;     /**< \brief pixels drawn by lines, bounds included **/
+
+    void blend(const int& x, const int& y, const uint32_t& color, const double& coverage);
+
+public:
+    Framebuffer(const size_t& width, const size_t& height, const uint32_t& background = 0xFFFFFF);
+
+    size_t width() const { return w; }
+    size_t height() const { return h; }
+    const unsigned char* data() const { return pixels.data(); }  /**< \brief rows from top to bottom, 4 bytes per pixel **/
+
+    /**
+     * limits lines to pixels x0..x1, y0..y1 (bounds included). The whole image by default.
+     */
+    void setClip(const int& x0, const int& y0, const int& x1, const int& y1);
+
+    void fillRect(const int& x0, const int& y0, const int& x1, const int& y1, const uint32_t& color); /**< \brief bounds included, not clipped **/
+
+    /**
+     * antialiased line, 1 pixel wide, between points given in pixels (centers at integer coordinates).
+     */
+    void drawLine(double x0, double y0, double x1, double y1, const uint32_t& color);
+
+    /**
+     * draws text with its top left corner at x, y. If vertical, text is rotated by 90 degrees
+     * counterclockwise and x, y is its bottom left corner.
+     */
+    void drawText(const int& x, const int& y, const string& text, const uint32_t& color, const int& scale = 1, const bool& vertical = false);
+
+    static int textWidth(const string& text, const int& scale = 1);   /**< \brief along the text **/
+    static int textHeight(const int& scale = 1);                      /**< \brief across the text **/
+
+    /**
+     * writes the image as a PNG file, see writePng.
+     */
+    bool savePng(const string& fileName) const;
+
+};
+
+
+#endif //GNUPLOT_FRAMEBUFFER_H
@@ -0,0 +1,36 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_GIFSTITCH_H
+#define GNUPLOT_GIFSTITCH_H
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/**
+ * joins animated GIF files (i.e. written by gnuplot "set term gif animate") in one animation,
+ * frames are copied as they are, without decoding them.
+ * Header, screen size and loop settings are taken from the first part. Frames of the other parts
+ * using a different global color table get it as their local color table.
+ * @param parts GIF files, in playing order. All of them should have the same size.
+ * @param fileName animation to be written
+ * @return false if a part cannot be read or is not a GIF file
+ */
+bool stitchGifs(const vector<string>& parts, const string& fileName);
+
+
+#endif //GNUPLOT_GIFSTITCH_H
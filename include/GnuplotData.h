@@ -0,0 +1,201 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_GNUPLOTDATA_H
+#define GNUPLOT_GNUPLOTDATA_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <streambuf>
+#include <utility>
+#include "FrameStore.h"
+#include "DataKernels.h"
+#include "DataView.h"
+#include "Histogram2D.h"
+
+using namespace std;
+
+enum class gnuplot_data_format{
+
+    GNUPLOT_TEXT,       /**< \brief one row of text per point **/
+    GNUPLOT_BINARY      /**< \brief raw little-endian doubles, read with gnuplot "binary record" **/
+
+};
+
+enum class gnuplot_data_transport{
+
+    GNUPLOT_FILE,       /**< \brief data is written in a temporary file **/
+    GNUPLOT_DATABLOCK,  /**< \brief data is sent inline with the commands as a gnuplot datablock (text only) **/
+    GNUPLOT_MEMFD       /**< \brief data is written in an anonymous memory file (Linux only) **/
+
+};
+
+/**
+ * Class FdStreamBuffer is a minimal buffered stream buffer writing to a file descriptor,
+ * so data can be serialized in memory files or sockets with the functions below.
+ * The descriptor is not closed by the buffer.
+ */
+class FdStreamBuffer : public streambuf {
+
+private:
+
+    int fd;
+    char buffer[1 << 16];
+
+    bool flushBuffer();
+
+protected:
+
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+public:
+    explicit FdStreamBuffer(int fd);
+    ~FdStreamBuffer();
+
+};
+
+/**
+ * true if doubles are stored little-endian, as expected by binaryDataSpec and binarySeriesSpec.
+ */
+bool hostIsLittleEndian();
+
+/**
+ * Class BinaryWriter packs doubles in a fixed size buffer, so the stream is written in large blocks.
+ * Values are written little-endian whatever the host is.
+ */
+class BinaryWriter {
+
+private:
+
+    ostream& out;
+    bool swap;
+    static const size_t bufferSize = 8192;
+    double buffer[bufferSize];
+    size_t n;
+
+public:
+    explicit BinaryWriter(ostream& out) : out(out), swap(!hostIsLittleEndian()), n(0) {}
+    ~BinaryWriter() { flush(); }
+
+    void flush() {
+        if (this->swap) {
+            // only on big-endian hosts: gnuplot is always told the data is little-endian
+            for (size_t k = 0; k < this->n; ++k) {
+                unsigned char* b = reinterpret_cast<unsigned char*>(&this->buffer[k]);
+                for (int l = 0; l < 4; ++l) std::swap(b[l], b[7 - l]);
+            }
+        }
+        this->out.write(reinterpret_cast<const char*>(this->buffer), this->n * sizeof(double));
+        this->n = 0;
+    }
+
+    void reserve(const size_t& count) {
+        if (this->n + count > bufferSize) flush();
+    }
+
+    void put(const double& value) {
+        this->buffer[this->n++] = value;
+    }
+
+};
+
+/**
+ * Functions used by GnuplotDriver to serialize data for gnuplot.
+ * Data is given as columns, row i of the output holds element i of every column.
+ * All the columns are expected to have (at least) the size of the first one.
+ */
+
+/**
+ * writes columns as text, one row per line.
+ * @param precision significant digits of numbers, 0 for the shortest text keeping the exact value (see formatDouble)
+ */
+void writeTextData(ostream& out, const vector<DataView>& columns, const int& precision = 0);
+
+/**
+ * writes columns as raw little-endian doubles, row by row.
+ * out must be opened in binary mode.
+ */
+void writeBinaryData(ostream& out, const vector<DataView>& columns);
+
+/**
+ * writes series i (x[i], y[i]) as its own block of text rows, blocks are separated by two blank lines
+ * so that series i can be read with gnuplot "index i". Empty series are skipped.
+ */
+void writeTextSeries(ostream& out, const vector<DataView>& x, const vector<DataView>& y, const int& precision = 0);
+
+/**
+ * writes series one after the other as x, y pairs of raw little-endian doubles.
+ * out must be opened in binary mode.
+ */
+void writeBinarySeries(ostream& out, const vector<DataView>& x, const vector<DataView>& y);
+
+/**
+ * writes every frame as its own block of text rows: x, then y of every curve. Frame f can be read
+ * with gnuplot "index f". Frames are read once, in storage order.
+ * @param yRange merged with the range of y values that can be plotted, positive ones only if logY
+ */
+void writeTextFrames(ostream& out, const DataView& x, const FrameStore& frames, ValueRange& yRange, const bool& logY,
+                     const int& precision = 0);
+
+/**
+ * as writeTextFrames, rows are written one after the other as raw little-endian doubles.
+ * Frame f is made of rows f*x.size() to (f+1)*x.size()-1.
+ */
+void writeBinaryFrames(ostream& out, const DataView& x, const FrameStore& frames, ValueRange& yRange, const bool& logY);
+
+/**
+ * returns the gnuplot modifiers needed to read data written by writeBinaryData,
+ * i.e. ` binary record=(100) format="%double%double" endian=little`
+ * @param nRows number of rows written
+ * @param nColumns number of columns written
+ */
+string binaryDataSpec(const size_t& nRows, const size_t& nColumns);
+
+/**
+ * returns the gnuplot modifiers needed to read ONE series written by writeBinarySeries.
+ * @param nRows number of points of the series
+ * @param offset position of the series in the data, in bytes
+ */
+string binarySeriesSpec(const size_t& nRows, const size_t& offset);
+
+/**
+ * writes the counts of histogram for gnuplot "with image": center x, center y and count of every bin,
+ * one line of text per bin and a blank line after every row of bins.
+ * @param logCounts if true empty bins are written as nan, so that gnuplot leaves them blank on a log color scale
+ */
+void writeTextImage(ostream& out, const Histogram2D& histogram, const bool& logCounts, const int& precision = 0);
+
+/**
+ * as writeTextImage, only the counts are written, row by row, as raw little-endian doubles (see binaryImageSpec).
+ */
+void writeBinaryImage(ostream& out, const Histogram2D& histogram, const bool& logCounts);
+
+/**
+ * returns the gnuplot modifiers needed to read data written by writeBinaryImage: grid size, bin size and
+ * center of the first bin. Only meaningful if bins are evenly spaced (no log axis).
+ */
+string binaryImageSpec(const Histogram2D& histogram);
+
+/**
+ * writes the bin edges of histogram for gnuplot "with pm3d" and corners2color c1, used when bins are not
+ * evenly spaced: one block of text per y edge, x edge, y edge and count of the bin having the point as
+ * lower left corner (0 on the last edges).
+ */
+void writeTextGrid(ostream& out, const Histogram2D& histogram, const bool& logCounts, const int& precision = 0);
+
+
+#endif //GNUPLOT_GNUPLOTDATA_H
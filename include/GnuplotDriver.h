@@ -19,6 +19,19 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include "GnuplotSession.h"
+#include "GnuplotData.h"
+#include "RenderQueue.h"
+#include "Decimation.h"
+#include "RingBuffer.h"
+#include "RenderCache.h"
+#include "DataFile.h"
+#include "PlotBackend.h"
+#include "PlotServer.h"
+#include <chrono>
 
 using namespace std;
 
@@ -47,18 +60,93 @@ enum class gnuplot_axis_type{
 
 };
 
+enum class gnuplot_animation_format{
+
+    GNUPLOT_GIF,
+    GNUPLOT_MP4,            /**< \brief frames are encoded with ffmpeg, if installed **/
+    GNUPLOT_PNG_FRAMES      /**< \brief one png per frame: <fileName>_000000.png, <fileName>_000001.png ... **/
+
+};
+
+/**
+ * settings for GnuplotDriver::exportAnimation
+ */
+struct AnimationExportOptions {
+
+    gnuplot_animation_format format = gnuplot_animation_format::GNUPLOT_GIF;
+    double dt = 0.1;                            /**< \brief seconds between frames **/
+    size_t threads = 0;                         /**< \brief gnuplot processes running at once, 0 uses every core **/
+    size_t width = 640;
+    size_t height = 480;
+    function<void(size_t, size_t)> progress;    /**< \brief if set, called with frames rendered so far and total frames **/
+
+};
+
+/**
+ * returned by GnuplotDriver::exportAnimation
+ */
+struct AnimationExportStats {
+
+    size_t frames = 0;
+    size_t chunks = 0;                          /**< \brief number of pieces frames were split in **/
+    double seconds = 0;
+    double framesPerSecond = 0;
+    int status = 0;                             /**< \brief 0 if every gnuplot (and ffmpeg) run succeeded **/
+
+};
+
+/**
+ * settings for GnuplotDriver::plotDensity
+ */
+struct DensityOptions {
+
+    size_t xBins = 256;
+    size_t yBins = 256;
+    size_t threads = 0;                         /**< \brief threads binning the points, 0 uses every core **/
+    bool logCounts = false;                     /**< \brief log color scale, empty bins are left blank **/
+
+};
+
+/**
+ * time spent and data written by one plot, see GnuplotDriver::setStats.
+ * Times are wall clock seconds.
+ */
+struct PlotStats {
+
+    double serializeSeconds = 0;    /**< \brief formatting data and writing it to its file, memory file or datablock **/
+    double commandSeconds = 0;      /**< \brief writing the command file, 0 if commands are sent through a pipe **/
+    double spawnSeconds = 0;        /**< \brief starting gnuplot (fork), 0 if a running session is used **/
+    double runSeconds = 0;          /**< \brief from gnuplot start (or script sent to the session) to the end of the plot **/
+    size_t dataBytes = 0;
+    size_t commandBytes = 0;
+    size_t pointsWritten = 0;       /**< \brief x, y pairs (or rows) written, after decimation **/
+    int status = 0;                 /**< \brief exit status of gnuplot **/
+    bool cacheHit = false;          /**< \brief the exported file was taken from the render cache, gnuplot did not run **/
+
+};
+
 /**
  * Class GnuplotDriver implements an handler for gnuplot to be called from c++ code.
- * Internally the class creates an input file that is used to run gnuplot.
- * As of now ONE object of the class can handle ONE 2D plot.
+ * Internally the class creates an input file that is used to run gnuplot, unless data is
+ * sent without files (see GnuplotDriver::setDataTransport). Temporary files are written in a private
+ * directory ($TMPDIR or /tmp, simplePlot_XXXXXX), created by the first plot needing it and removed by the destructor.
+ * Drivers share no state: many of them can be created and used at once by different threads and processes,
+ * as long as each driver is used by one thread at a time.
+ * As of now ONE object of the class can handle ONE 2D plot at a time: settings are kept
+ * between calls to GnuplotDriver::plot, so the same driver can be used to plot again.
+ * If a GnuplotSession is set, gnuplot is not spawned for every plot: commands are sent
+ * to the session instead (see GnuplotDriver::setSession), or to a plot server (see GnuplotDriver::setServer).
  *
  * See file src/main.cpp for some examples on how to use this library
  */
 class GnuplotDriver {
 
+    friend class Figure;
+    friend class GnuplotBackend;
+
 private:
 
-    int id;
+    string sessionDir;          /**< \brief private directory of the temporary files, created when the first one is written **/
     string commandFileName;
     string dataFileName;
 
@@ -66,29 +154,205 @@ private:
     gnuplot_save_type saveType; /** \brief if action is GNUPLOT_SAVE plot will be exported in wanted format instead of being displayed**/
     gnuplot_axis_type axisType;
     string saveName;            /** \brief if action is GNUPLOT_SAVE, file to be exported **/
-    ofstream commandFile;       /**< \brief  fstream for gnuplot input file **/
+    string commands;            /**< \brief gnuplot commands set so far, written before each plot **/
     string plotOptions;         /**< \brief set plot options. Default is "with lines" **/
+    size_t saveWidth, saveHeight; /**< \brief size of exported png in pixels, 0 for the terminal default (640x480) **/
+    gnuplot_data_format dataFormat; /**< \brief how data is written for gnuplot. Default is GNUPLOT_TEXT **/
+    gnuplot_data_transport dataTransport; /**< \brief where data is written for gnuplot. Default is GNUPLOT_FILE **/
+    int dataPrecision;          /**< \brief significant digits of text data, 0 (default) keeps the exact values **/
+    gnuplot_decimation_type decimation; /**< \brief series reduction before writing. Default is GNUPLOT_NO_DECIMATION **/
+    size_t decimationPixels;    /**< \brief width of the plot in pixels, used by decimation **/
+    bool xRangeSet;             /**< \brief true if setXRange has been called **/
+    double xRangeMin, xRangeMax; /**< \brief x range set with setXRange **/
+    string dataBlock;           /**< \brief if dataTransport is GNUPLOT_DATABLOCK, data to be sent before next plot command **/
+    int dataFd;                 /**< \brief if dataTransport is GNUPLOT_MEMFD, memory file holding last data, -1 otherwise **/
 
     vector<string> legendTitles;
 
-    static vector<vector<vector<double>>> videoData;
+    // settings also kept apart from GnuplotDriver::commands, for backends other than gnuplot
+    string titleText, xLabelText, yLabelText;
+    int titleFontSize, xLabelFontSize, yLabelFontSize;
+    bool yRangeSet;
+    double yRangeMin, yRangeMax;
+
+    shared_ptr<PlotBackend> backend; /**< \brief if not null, renders the png exports it can instead of gnuplot **/
+
+    shared_ptr<GnuplotSession> session; /**< \brief if not null, gnuplot session used to plot **/
+    shared_ptr<PlotClient> server;      /**< \brief if not null, plot server used to plot **/
+    string serverData;          /**< \brief if server is set, data to be sent with next script **/
+    vector<RingBuffer> streams; /**< \brief series filled by GnuplotDriver::push **/
+    vector<unsigned long long> streamSent; /**< \brief for every stream, samples already sent to gnuplot **/
+    size_t streamCapacity;      /**< \brief samples kept for every stream, 0 if streaming is not set **/
+    double streamPeriod;        /**< \brief minimum time between two refreshes, in seconds **/
+    chrono::steady_clock::time_point lastRefresh;
 
-    string getTitle(const string& str);
+    shared_ptr<RenderQueue> renderQueue; /**< \brief queue used by plotAsync and saveAsync **/
 
+    FrameStore frames;          /**< \brief if action is GNUPLOT_VIDEO, frames to be played by playAnimation **/
+
+    shared_ptr<RenderCache> renderCache; /**< \brief if not null, exported files are looked up here before running gnuplot **/
+    Hasher64 dataHasher;        /**< \brief hash of the data written by GnuplotDriver::writeData, if renderCache is set **/
+    bool dataHashed;            /**< \brief true if dataHasher holds the data of the plot being made **/
+    string dataSource;          /**< \brief returned by the last GnuplotDriver::writeData **/
+
+    bool statsOn;               /**< \brief true if plots are timed, see GnuplotDriver::setStats **/
+    PlotStats stats;            /**< \brief stats of the plot being made **/
+    PlotStats previousStats;    /**< \brief stats of the last plot made **/
+    function<void(const PlotStats&)> statsCallback;
+
+    /**
+     * ends the stats of the plot being made: they become GnuplotDriver::lastStats and are given to the callback.
+     */
+    void finishStats(const int& status);
 
     /**
-     * writes command in gnuplot input file GnuplotDriver::commandFile.
-     * @param command string to be written to file
+     * creates GnuplotDriver::sessionDir, if not done yet, and names the command and data files in it.
+     */
+    void makeSessionDir();
+
+    string getTitle(const string& str) const;
+
+
+    /**
+     * appends command to GnuplotDriver::commands.
+     * @param command string to be written to gnuplot input
      */
     void write_command(const string& command);
 
     /**
-     * writes lines needed in gnuplot input file for saving the plot.
+     * returns lines needed in gnuplot input for saving the plot.
      * Sets the right terminal (png or epscairo) and sets the output file.
      */
-    void write_action_save();
+    string write_action_save();
+
+    /**
+     * returns axis type and commands set so far, everything describing the plot but the data.
+     */
+    string axisSettings() const;
+
+    /**
+     * builds the full gnuplot input: terminal, axis type, commands set so far and plotCommand.
+     */
+    string buildScript(const string& plotCommand);
+
+    /**
+     * true if data is written as binary: GNUPLOT_BINARY format, unless data is sent in a datablock.
+     */
+    bool binaryData() const;
+
+    /**
+     * calls write on the data sink selected by GnuplotDriver::dataTransport,
+     * i.e. the (tmp) data file GnuplotDriver::dataFileName.
+     * @param write serializes data, as binary if GnuplotDriver::binaryData is true
+     * @return data source to be used in the plot command: quoted file name or datablock name
+     */
+    string writeData(const function<void(ostream&)>& write);
+    string writeDataTo(const function<void(ostream&)>& write); /**< \brief as writeData, without hashing **/
+
+    /**
+     * plots series i as x[i], y[i]. Every series is written as its own block, so dimensions can differ.
+     * @return exit status of gnuplot
+     */
+    int plotSeries(const vector<DataView>& x, const vector<DataView>& y);
+
+    /**
+     * fills titles with the legend titles of nSeries series.
+     * @return true if no legend title is set, so the legend has to be hidden
+     */
+    bool seriesTitles(const size_t& nSeries, vector<string>& titles) const;
 
-    void executeGnuplot();
+    /**
+     * builds the command plotting series written in source by writeTextSeries or writeBinarySeries.
+     * Only the sizes of x are needed: every y has the size of its x.
+     * @param block index of the first text block of the series, incremented for every series written
+     * @param offset byte offset of the first binary series, incremented by the size of every series written
+     * @return plot command, empty if all the series are empty
+     */
+    string seriesPlot(const string& source, const bool& binary, const vector<DataView>& x,
+                      const vector<string>& titles, const bool& noLegend, size_t& block, size_t& offset) const;
+
+    /**
+     * plotFile when the file has to be read: decimated series are plotted with GnuplotDriver::plotBlocks.
+     * @return exit status of gnuplot
+     */
+    int plotFileDecimated(const DataFile& file, const vector<size_t>& columns,
+                          const function<double(double)>& xTransform, const function<double(double)>& yTransform,
+                          const vector<string>& titles, const bool& noLegend);
+
+    /**
+     * plotFile when the file has to be read: transformed columns are written as rows x, y0, y1...
+     * @return exit status of gnuplot
+     */
+    int plotFileTransformed(const DataFile& file, const vector<size_t>& columns,
+                            const function<double(double)>& xTransform, const function<double(double)>& yTransform,
+                            const vector<string>& titles, const bool& noLegend);
+
+    /**
+     * the plot of series x, y as GnuplotDriver::backend sees it.
+     */
+    PlotScene scene(const vector<DataView>& x, const vector<DataView>& y,
+                    const vector<string>& titles, const bool& noLegend) const;
+
+    /**
+     * writes the series and plots them, one data block per series.
+     * If the plot is exported as png and GnuplotDriver::backend can render it, no data is written:
+     * the backend renders the series in process.
+     * @return exit status of gnuplot (or of the backend)
+     */
+    int plotBlocks(const vector<DataView>& x, const vector<DataView>& y,
+                   const vector<string>& titles, const bool& noLegend);
+
+    /**
+     * writes in the data file (or memory file) the samples pushed since last refresh.
+     * Stream s uses a fixed region of the file, laid out as its RingBuffer, so only new samples are written.
+     * @return quoted name of the data file
+     */
+    string writeStreamUpdates();
+
+    /**
+     * writes the frames of GnuplotDriver::frames for gnuplot.
+     * @param settings set to the commands to be run before plotting frames (y range of all the frames)
+     * @return command plotting frame t, to be used in a "do for [t=...]" loop. Empty if there is no frame.
+     */
+    string writeFrames(const DataView& x, string& settings);
+
+    /**
+     * removes from the series the points that cannot be plotted on a log axis: not finite or not positive.
+     * Copies of the series are stored in px, py and x, y are pointed to them; nothing is copied
+     * if every point can be plotted, or if no axis is logarithmic.
+     */
+    void dropUnplottable(vector<DataView>& x, vector<DataView>& y,
+                         vector<vector<double>>& px, vector<vector<double>>& py);
+
+    /**
+     * reduces the series according to GnuplotDriver::decimation. Reduced series are stored in dx, dy
+     * and x, y are pointed to them. Series that are already small enough are not touched.
+     */
+    void decimate(vector<DataView>& x, vector<DataView>& y,
+                  vector<vector<double>>& dx, vector<vector<double>>& dy);
+
+    /**
+     * returns a new driver with the same settings, used to render a job in background.
+     * @param actionType action of the new driver
+     * @param fileName file exported if actionType is GNUPLOT_SAVE
+     */
+    shared_ptr<GnuplotDriver> snapshot(const gnuplot_action_type& actionType, const string& fileName);
+
+    future<int> queueJob(const shared_ptr<GnuplotDriver>& job, vector<vector<double>>&& x, vector<vector<double>>&& y);
+
+    /**
+     * runs script either in GnuplotDriver::session or in a new gnuplot process, unless the exported
+     * file is found in GnuplotDriver::renderCache.
+     * @return exit status of gnuplot
+     */
+    int executeGnuplot(const string& script);
+
+    int runGnuplot(const string& script);
+
+    /**
+     * key of the plot in the render cache: hash of the data and of script, temporary names excluded.
+     */
+    uint64_t cacheKey(const string& script) const;
 
 public:
     GnuplotDriver(gnuplot_axis_type axis = gnuplot_axis_type::GNUPLOT_LINEAR, gnuplot_action_type action_type = gnuplot_action_type::GNUPLOT_PLOT, string fileName = "plot.png", gnuplot_save_type format = gnuplot_save_type::GNUPLOT_PNG);
@@ -105,13 +369,172 @@ public:
     void setYLabel(const string& str, const int& fontSize = 20);
 
     void setLegendTitles(const vector<string>& ss);
+    void setDataFormat(const gnuplot_data_format& format); /**< \brief GNUPLOT_BINARY sends raw doubles instead of text **/
+    void setDataTransport(const gnuplot_data_transport& transport); /**< \brief GNUPLOT_DATABLOCK or GNUPLOT_MEMFD do not write files **/
+    void setPrecision(const int& digits);                 /**< \brief significant digits of text data, 0 (default) keeps the exact values **/
+    /**
+     * reduces every series to what can be seen on a plot pixels wide before writing it.
+     * The x range set with setXRange (or the range of data) and log x axis are taken into account.
+     * @param type GNUPLOT_MINMAX keeps the plot identical, GNUPLOT_LTTB keeps about 2*pixels points
+     * @param pixels width of the plot, default is the one of gnuplot png terminal
+     */
+    void setDecimation(const gnuplot_decimation_type& type, const size_t& pixels = 640);
+    void setFrameStoreLimit(const size_t& bytes);         /**< \brief frames taking more memory are moved to a mapped file **/
+    void setSaveName(const string& fileName);             /**< \brief file exported by next plot if action is GNUPLOT_SAVE **/
+    void setSaveSize(const size_t& width, const size_t& height); /**< \brief size of exported png in pixels, default 640x480 **/
+
+    /**
+     * renders png exports (GNUPLOT_SAVE) in process with b, i.e. make_shared<RasterBackend>(): no gnuplot
+     * is started and no data is written. Plots b cannot render (see PlotBackend::canRender), eps exports,
+     * windows, animations and files read by gnuplot (plotFile without decimation and transforms) are still
+     * made by gnuplot. A backend can be shared by many drivers and threads.
+     * @param b backend to be used, null (default) to always use gnuplot
+     */
+    void setBackend(const shared_ptr<PlotBackend>& b);
+
+    /**
+     * plots through a persistent gnuplot session instead of spawning gnuplot for every plot.
+     * @param s session to be used, i.e. GnuplotSession::processSession(). If null the driver starts its own session.
+     */
+    void setSession(const shared_ptr<GnuplotSession>& s = nullptr);
+
+    /**
+     * plots through a running simplePlot-server: scripts and data are sent over its socket, nothing is spawned
+     * or written here. Data is sent in the format set with setDataFormat, and in the script if the transport
+     * is GNUPLOT_DATABLOCK. Relative file names are relative to the working directory of this process.
+     * @param c connection to the server, i.e. make_shared<PlotClient>(). Can be shared by many drivers. If null,
+     * plots are made here again.
+     */
+    void setServer(const shared_ptr<PlotClient>& c);
 
     void plot(const vector<double>& x, const vector<double>& y);
-    void plot(const vector<double>& x0, const vector<double>& y0, const vector<double>& x1, const vector<double>& y1);
-    void plot(const vector<double>& x0, const vector<double>& y0, const vector<double>& x1, const vector<double>& y1, const vector<double>& x2, const vector<double>& y2);
-    void plot(const vector<double>& x0, const vector<double>& y0, const vector<double>& x1, const vector<double>& y1, const vector<double>& x2, const vector<double>& y2, const vector<double>& x3, const vector<double>& y3);
+    void plot(const vector<vector<double>>& x, const vector<vector<double>>& y); /**< \brief series i is x[i], y[i] **/
+
+    /**
+     * plots data where it is, i.e. plot(DataView(xs, n), DataView::column(records, n, &Record::value)).
+     * Data is read during the call only, nothing is copied unless it has to be filtered or decimated.
+     */
+    void plot(const DataView& x, const DataView& y);
+
+    /**
+     * plots the series indexed by pyramid, reading only the points visible in the x range set with setXRange
+     * (the whole series if not set) on a plot as wide as the pixels set with setDecimation (640 by default):
+     * the cost does not depend on the size of the series, so the same series can be zoomed in again and again.
+     */
+    void plot(const MinMaxPyramid& pyramid);
+
+    /**
+     * series i is x[i], y[i]: vectors of DataView, or of vectors of any arithmetic type.
+     * A template, so that plot({x0, x1}, {y0, y1}) keeps meaning vector<vector<double>>.
+     */
+    template<typename View, typename = typename enable_if<is_convertible<const View&, DataView>::value>::type>
+    void plot(const vector<View>& x, const vector<View>& y) {
+        plotSeries(vector<DataView>(x.begin(), x.end()), vector<DataView>(y.begin(), y.end()));
+    }
+
+    /**
+     * plots any number of series: plot(x0, y0, x1, y1, x2, y2, ...).
+     * Each series is an x, y pair of vectors or DataView; different series can have different dimensions.
+     */
+    template<typename... Series>
+    void plot(const DataView& x0, const DataView& y0, const DataView& x1, const DataView& y1, const Series&... series) {
+
+        static_assert(sizeof...(Series) % 2 == 0, "GnuplotDriver::plot needs an x and a y for every series");
+
+        const vector<DataView> all = {x0, y0, x1, y1, DataView(series)...};
+        vector<DataView> x, y;
+        for (size_t i = 0; i < all.size(); i += 2) {
+            x.push_back(all[i]);
+            y.push_back(all[i+1]);
+        }
+
+        plotSeries(x, y);
+    }
+
+    /**
+     * plots columns of a data file written by another program, without loading it in memory.
+     * If no decimation and no transform is set, gnuplot reads the file itself and nothing is copied.
+     * Otherwise the file is mapped and read once (twice if no x range is set) and only the decimated series,
+     * or the transformed columns, are written for gnuplot. Decimation of files always uses GNUPLOT_MINMAX,
+     * which needs one pixel column at a time; rows are expected in order of x.
+     * @param xColumn, yColumns columns in the file, from 0. Series k is yColumns[k] against xColumn
+     * @param xTransform, yTransform if set, applied to every x and y value read
+     */
+    void plotFile(const string& fileName, const FileLayout& layout, const size_t& xColumn, const vector<size_t>& yColumns,
+                  const function<double(double)>& xTransform = nullptr, const function<double(double)>& yTransform = nullptr);
+
+    /**
+     * plots the density of a scatter set, i.e. millions of particle positions, as a 2D histogram:
+     * points are binned in parallel and only the grid is sent to gnuplot, so the cost of the plot depends
+     * on the number of bins, not of points. Bounds are the ranges set with setXRange and setYRange,
+     * or the ranges of the data; on a log axis bins are evenly spaced in log scale.
+     * Grids are drawn "with image", or "with pm3d" in map view if an axis is logarithmic.
+     */
+    void plotDensity(const DataView& x, const DataView& y, const DensityOptions& options = DensityOptions());
+
+    /**
+     * plots a histogram filled by the caller, i.e. with points given in many calls to Histogram2D::add.
+     */
+    void plotDensity(const Histogram2D& histogram, const bool& logCounts = false);
+
+    void playAnimation(const DataView &x, const double &dt = 0.1);
+
+    /**
+     * renders the frames stored in GNUPLOT_VIDEO mode to fileName. Frames are split in chunks rendered
+     * in parallel, each chunk by its own gnuplot process; GIF chunks are then joined in one animation.
+     * Those processes are local: if a server is set, it is not used here. Frames are read by every
+     * chunk from one memory file (or file), even if dataTransport is GNUPLOT_DATABLOCK.
+     */
+    AnimationExportStats exportAnimation(const DataView &x, const string& fileName,
+                                         const AnimationExportOptions& options = AnimationExportOptions());
+
+    /**
+     * turns the driver into a live plot: samples are added with GnuplotDriver::push and the plot is
+     * refreshed, at most maxFps times per second, in a persistent gnuplot session (started if not set).
+     * Only the last capacity samples of every series are kept.
+     */
+    void setStreaming(const size_t& capacity, const double& maxFps = 10);
+
+    /**
+     * appends a sample to series and refreshes the plot if more than 1/maxFps seconds have passed.
+     */
+    void push(const size_t& series, const double& x, const double& y);
+
+    /**
+     * plots the samples held by the streams. Called by GnuplotDriver::push, can be called to show last samples.
+     * @return exit status of gnuplot
+     */
+    int refresh();
+
+    /**
+     * times every plot: data serialization, command file, gnuplot start and run. Off by default,
+     * when off no clock is read.
+     * @param callback if set, called with the stats at the end of every plot. Plots made by plotAsync
+     *        and saveAsync call it from the thread of the render queue
+     */
+    void setStats(const bool& enabled, const function<void(const PlotStats&)>& callback = nullptr);
+    const PlotStats& lastStats() const { return previousStats; }  /**< \brief stats of the last plot, if enabled **/
+
+    /**
+     * looks up exported files (GNUPLOT_SAVE) in cache before running gnuplot, and stores them after.
+     * @param cache cache to be used, it can be shared between drivers. If null no cache is used.
+     */
+    void setRenderCache(const shared_ptr<RenderCache>& cache);
+
+    /**
+     * queue used by plotAsync and saveAsync, it can be shared between drivers.
+     * @param q queue to be used. If null the driver creates its own queue.
+     */
+    void setRenderQueue(const shared_ptr<RenderQueue>& q = nullptr);
+
+    // non blocking versions of GnuplotDriver::plot: data is moved (or copied) and rendered in background.
+    // Settings are taken when the function is called. The future holds the exit status of gnuplot.
+    future<int> plotAsync(vector<double> x, vector<double> y);
+    future<int> plotAsync(vector<vector<double>> x, vector<vector<double>> y);
 
-    void playAnimation(const vector<double> &x, const double &dt = 0.1);
+    // as plotAsync, but the plot is exported in fileName whatever the action of the driver is
+    future<int> saveAsync(const string& fileName, vector<double> x, vector<double> y);
+    future<int> saveAsync(const string& fileName, vector<vector<double>> x, vector<vector<double>> y);
 
 
 };
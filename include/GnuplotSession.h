@@ -0,0 +1,101 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_GNUPLOTSESSION_H
+#define GNUPLOT_GNUPLOTSESSION_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+
+using namespace std;
+
+/**
+ * Class GnuplotSession keeps ONE long-lived gnuplot process and feeds it through its stdin.
+ * Every script sent with GnuplotSession::run is followed by a marker that gnuplot prints back
+ * on its stdout, so the caller knows when the plot has been rendered.
+ * If gnuplot dies (i.e. after an error in a script) it is restarted on the next call.
+ *
+ * A session can be owned by a single GnuplotDriver or shared by many of them,
+ * see GnuplotSession::processSession.
+ */
+class GnuplotSession {
+
+private:
+
+    pid_t pid;                  /**< \brief pid of the gnuplot process, -1 if not running **/
+    int fd;                     /**< \brief our end of the socket connected to gnuplot stdin/stdout **/
+    bool persist;               /**< \brief if true gnuplot is started with --persist **/
+    unsigned long nScripts;     /**< \brief number of scripts sent, used to build unique markers **/
+    unsigned long nStarts;      /**< \brief number of times gnuplot was started **/
+    string readBuffer;          /**< \brief gnuplot stdout not consumed yet **/
+    mutex lock;
+
+    void start();
+    bool running();             /**< \brief as isAlive, lock must be held **/
+
+    /**
+     * closes the connection and reaps gnuplot.
+     * @return exit status of gnuplot
+     */
+    int stop();
+
+    bool writeAll(const char* buf, size_t n);
+
+    /**
+     * reads gnuplot stdout until the line marker is found.
+     * @return false if gnuplot closed its stdout before printing the marker
+     */
+    bool waitMarker(const string& marker);
+
+    /**
+     * sends script, after a reset if reset is true, and waits until it has been executed.
+     */
+    int execute(const string& script, const bool& reset);
+
+public:
+    GnuplotSession(bool persist = true);
+    ~GnuplotSession();
+
+    GnuplotSession(const GnuplotSession&) = delete;
+    GnuplotSession& operator=(const GnuplotSession&) = delete;
+
+    /**
+     * sends script to gnuplot and waits until it has been executed.
+     * The session is reset before the script, so settings do not leak between scripts.
+     * @return 0 on success, non zero if gnuplot died while executing the script
+     */
+    int run(const string& script);
+
+    /**
+     * as run, without resetting the session: settings and datablocks of previous scripts are kept,
+     * unless gnuplot was restarted in between (see GnuplotSession::startCount).
+     */
+    int update(const string& script);
+
+    bool isAlive();                 /**< \brief true if the gnuplot process is running **/
+    void restart();                 /**< \brief kills (if needed) and starts again gnuplot **/
+    unsigned long startCount();     /**< \brief times gnuplot was started: a new value means its state was lost **/
+
+    /**
+     * returns the session shared by the whole process. It is started on first use.
+     */
+    static shared_ptr<GnuplotSession> processSession();
+
+};
+
+
+#endif //GNUPLOT_GNUPLOTSESSION_H
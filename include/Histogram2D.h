@@ -0,0 +1,87 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_HISTOGRAM2D_H
+#define GNUPLOT_HISTOGRAM2D_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "DataView.h"
+#include "DataKernels.h"
+
+using namespace std;
+
+/**
+ * Class Histogram2D counts the points of a scatter set falling in each cell of a grid of
+ * xBins x yBins cells spanning [xMin, xMax] x [yMin, yMax]. On a log axis bins are evenly spaced
+ * in log scale. Points outside the grid, not finite, or not positive on a log axis are not counted.
+ * Points are binned in parallel: every thread fills its own counts, which are summed at the end,
+ * so the cost is one pass over the points plus one over the grid per thread.
+ */
+class Histogram2D {
+
+private:
+
+    size_t nx, ny;
+    double xMin, xMax, yMin, yMax;
+    bool logX, logY;
+    double x0, xScale, y0, yScale;  /**< \brief bin of v is (v - x0) * xScale, v in log scale on a log axis **/
+    vector<uint64_t> counts;        /**< \brief count of bin (i, j) is counts[j * nx + i] **/
+    uint64_t binned;
+    uint64_t dropped;
+
+    /**
+     * adds points [first, last) to counts, that has nx * ny bins.
+     * @return number of points binned
+     */
+    uint64_t binRange(const DataView& x, const DataView& y, const size_t& first, const size_t& last,
+                      uint64_t* counts) const;
+
+public:
+    Histogram2D(const size_t& xBins, const size_t& yBins,
+                const double& xMin, const double& xMax, const double& yMin, const double& yMax,
+                const bool& logX = false, const bool& logY = false);
+
+    /**
+     * adds the points x[k], y[k] to the counts, so that a set can be binned in many calls.
+     * @param threads threads binning at once, 0 uses every core. Small sets are binned by fewer threads
+     */
+    void add(const DataView& x, const DataView& y, const size_t& threads = 0);
+
+    size_t xBins() const { return nx; }
+    size_t yBins() const { return ny; }
+    bool xLog() const { return logX; }
+    bool yLog() const { return logY; }
+    uint64_t count(const size_t& i, const size_t& j) const { return counts[j * nx + i]; }
+    uint64_t total() const { return binned; }           /**< \brief points counted so far **/
+    uint64_t outside() const { return dropped; }        /**< \brief points given but not counted **/
+    uint64_t maxCount() const;
+
+    double xEdge(const size_t& i) const;    /**< \brief left edge of column i, xEdge(xBins()) is xMax **/
+    double yEdge(const size_t& j) const;    /**< \brief bottom edge of row j, yEdge(yBins()) is yMax **/
+    double xCenter(const size_t& i) const;  /**< \brief center of column i, in log scale on a log axis **/
+    double yCenter(const size_t& j) const;
+
+};
+
+/**
+ * range of the finite values (positive ones only if positiveOnly) as valueRange, split between threads.
+ * @param threads threads scanning at once, 0 uses every core
+ */
+ValueRange parallelValueRange(const DataView& values, const bool& positiveOnly = false, const size_t& threads = 0);
+
+
+#endif //GNUPLOT_HISTOGRAM2D_H
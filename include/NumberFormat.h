@@ -0,0 +1,84 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_NUMBERFORMAT_H
+#define GNUPLOT_NUMBERFORMAT_H
+
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * longest text written by formatDouble, i.e. "-1.2345678901234567e-308"
+ */
+const size_t maxNumberLength = 32;
+
+/**
+ * writes value in buffer as text gnuplot can read, whatever the locale is ('.' as decimal separator).
+ * No terminating null character is written.
+ * @param buffer at least maxNumberLength characters
+ * @param precision significant digits, 1 to 17. 0 writes the shortest text that reads back as the same
+ *        double (for very few values one digit more), so no information is lost
+ * @return number of characters written
+ */
+size_t formatDouble(char* buffer, const double& value, const int& precision = 0);
+
+/**
+ * as formatDouble, returns the text as a string. Used for numbers in gnuplot commands.
+ */
+string formatNumber(const double& value, const int& precision = 0);
+
+/**
+ * Class TextWriter formats numbers and text in a large buffer, written to the stream only when full
+ * or when the writer is flushed (or destroyed), so the stream sees few large writes.
+ */
+class TextWriter {
+
+private:
+
+    ostream& out;
+    int precision;
+    static const size_t bufferSize = 1 << 16;
+    char buffer[bufferSize];
+    size_t n;
+
+public:
+    explicit TextWriter(ostream& out, const int& precision = 0) : out(out), precision(precision), n(0) {}
+    ~TextWriter() { flush(); }
+
+    TextWriter(const TextWriter&) = delete;
+    TextWriter& operator=(const TextWriter&) = delete;
+
+    void flush() {
+        this->out.write(this->buffer, this->n);
+        this->n = 0;
+    }
+
+    void put(const double& value) {
+        if (this->n + maxNumberLength > bufferSize) flush();
+        this->n += formatDouble(this->buffer + this->n, value, this->precision);
+    }
+
+    void put(const char& c) {
+        if (this->n == bufferSize) flush();
+        this->buffer[this->n++] = c;
+    }
+
+};
+
+
+#endif //GNUPLOT_NUMBERFORMAT_H
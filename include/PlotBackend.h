@@ -0,0 +1,84 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_PLOTBACKEND_H
+#define GNUPLOT_PLOTBACKEND_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "DataView.h"
+
+using namespace std;
+
+/**
+ * everything a 2D plot shows, as set on a GnuplotDriver: series, labels, axes and legend.
+ * Series are views: they are valid during PlotBackend::render only.
+ */
+struct PlotScene {
+
+    vector<DataView> x, y;          /**< \brief series i is x[i], y[i] **/
+    vector<string> titles;          /**< \brief legend title of every series, empty titles are not shown **/
+    bool noLegend = false;          /**< \brief true if the legend is hidden **/
+    string plotOptions = " w l";    /**< \brief gnuplot plot options, i.e. " w l" **/
+
+    string title, xLabel, yLabel;
+    int titleFont = 0, xLabelFont = 0, yLabelFont = 0; /**< \brief font sizes, 0 for the default one **/
+
+    bool logX = false, logY = false;
+    bool xRangeSet = false, yRangeSet = false;  /**< \brief otherwise ranges are computed from data **/
+    double xMin = 0, xMax = 0, yMin = 0, yMax = 0;
+
+    size_t width = 640, height = 480;   /**< \brief size of the image in pixels **/
+
+};
+
+/**
+ * Class PlotBackend renders a PlotScene to an image file. Implementations must be safe to call
+ * from many threads at once, so that one backend can be shared by every driver.
+ * See GnuplotDriver::setBackend.
+ */
+class PlotBackend {
+
+public:
+    virtual ~PlotBackend() {}
+
+    /**
+     * false if scene uses something the backend cannot draw: the plot is then made by gnuplot.
+     */
+    virtual bool canRender(const PlotScene& scene) const = 0;
+
+    /**
+     * renders scene to fileName, as a png.
+     * @return 0 on success, as the exit status of gnuplot
+     */
+    virtual int render(const PlotScene& scene, const string& fileName) = 0;
+
+};
+
+/**
+ * Class GnuplotBackend renders scenes with gnuplot, through a GnuplotDriver made for every scene.
+ * It can render every scene.
+ */
+class GnuplotBackend : public PlotBackend {
+
+public:
+    bool canRender(const PlotScene& scene) const override;
+    int render(const PlotScene& scene, const string& fileName) override;
+
+};
+
+
+#endif //GNUPLOT_PLOTBACKEND_H
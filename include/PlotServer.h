@@ -0,0 +1,198 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_PLOTSERVER_H
+#define GNUPLOT_PLOTSERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "GnuplotSession.h"
+
+using namespace std;
+
+/**
+ * Plot server: a long running process (simplePlot-server) keeping a pool of warm gnuplot sessions,
+ * fed by many short lived processes through a local Unix socket (see GnuplotDriver::setServer).
+ *
+ * Every request is a fixed header followed by the working directory of the client, the gnuplot script
+ * and the plot data; every reply is a header followed by a payload (the stats, as text, for a stats request).
+ * Data is written by the server in a memory file of its own, and serverDataSource in the script is
+ * replaced by its name. Scripts are run from the working directory of the client, so relative file names
+ * keep their meaning.
+ */
+
+/**
+ * placeholder of the data file in scripts sent to a server.
+ */
+extern const char* const serverDataSource;
+
+/**
+ * socket used when none is given: $XDG_RUNTIME_DIR/simplePlot.sock, or /tmp/simplePlot-<uid>.sock.
+ */
+string defaultServerSocket();
+
+/**
+ * state of a server, see PlotServer::stats and PlotClient::stats.
+ */
+struct ServerStats {
+
+    size_t workers = 0;             /**< \brief gnuplot sessions running jobs **/
+    size_t connections = 0;         /**< \brief clients connected now **/
+    size_t queueDepth = 0;          /**< \brief jobs waiting for a worker now **/
+    size_t maxQueueDepth = 0;       /**< \brief highest queue depth seen **/
+    uint64_t jobs = 0;              /**< \brief jobs done **/
+    uint64_t failed = 0;            /**< \brief jobs whose gnuplot did not succeed **/
+    uint64_t dataBytes = 0;         /**< \brief plot data received **/
+    double waitMs50 = 0, waitMs99 = 0;          /**< \brief time spent in the queue, median and 99th percentile **/
+    double latencyMs50 = 0, latencyMs90 = 0, latencyMs99 = 0; /**< \brief from job received to job done **/
+
+    string toText() const;                      /**< \brief one "name value" line per field **/
+    static ServerStats fromText(const string& text);
+
+};
+
+/**
+ * Class PlotServer accepts clients on a Unix socket and runs their jobs on a pool of workers, each owning
+ * a gnuplot session started once. Jobs wait in one queue, in order of arrival; a worker takes all the jobs
+ * queued (up to a batch, and leaving their share to the other workers) at once, so that under load workers
+ * are woken once per batch instead of once per job.
+ * The queue holds at most maxDepth jobs: clients sending more wait for a free slot.
+ */
+class PlotServer {
+
+private:
+
+    struct Job {
+        string cwd;
+        string script;
+        string data;
+        chrono::steady_clock::time_point received;
+        promise<int> status;
+    };
+
+    string socketPath;
+    int listenFd;
+    int wakePipe[2];            /**< \brief written by PlotServer::stop to wake the accept loop **/
+    size_t nWorkers;
+    size_t maxDepth;
+    size_t batchSize;
+
+    deque<unique_ptr<Job>> jobs;
+    bool stopping;
+    mutex lock;
+    condition_variable notEmpty;
+    condition_variable notFull;
+    vector<thread> workers;
+
+    set<int> clients;           /**< \brief sockets of the connected clients **/
+    size_t activeClients;       /**< \brief threads serving a client, the destructor waits for them **/
+    condition_variable clientsDone;
+
+    // stats, under lock
+    size_t maxQueueDepth;
+    uint64_t nJobs, nFailed, nDataBytes;
+    vector<double> waits, latencies;    /**< \brief last jobs, in ms, written round robin **/
+    size_t nextSample;
+
+    void work();                /**< \brief worker loop **/
+    void serve(int fd);         /**< \brief serves a client, then closes its connection **/
+    void serveRequests(const int& fd); /**< \brief reads requests of a client until it disconnects or sends too much **/
+    int submit(unique_ptr<Job> job); /**< \brief queues job and waits for its exit status **/
+
+    /**
+     * runs job in session, data being written in the memory file (or file) dataFd.
+     * @return exit status of gnuplot
+     */
+    int runJob(Job& job, GnuplotSession& session, const int& dataFd, const string& dataName);
+
+public:
+    /**
+     * binds socket: a stale socket is replaced, a socket another server is listening on is an error.
+     * @param workers gnuplot sessions, 0 for one per core
+     * @param maxDepth jobs waiting at most, clients beyond it wait
+     * @param batch jobs a worker takes at once
+     */
+    PlotServer(const string& socket = defaultServerSocket(), const size_t& workers = 0,
+               const size_t& maxDepth = 1024, const size_t& batch = 8);
+    ~PlotServer();
+
+    PlotServer(const PlotServer&) = delete;
+    PlotServer& operator=(const PlotServer&) = delete;
+
+    /**
+     * accepts clients and runs their jobs until PlotServer::stop is called.
+     */
+    void run();
+
+    /**
+     * makes PlotServer::run return, pending jobs are still run. Async-signal-safe.
+     */
+    void stop();
+
+    ServerStats stats();
+    const string& socket() const { return socketPath; }
+
+};
+
+/**
+ * Class PlotClient is the connection of a process to a PlotServer. It can be shared by many drivers and
+ * threads: jobs are sent one at a time, each waiting for its reply. The connection is opened on first use
+ * and opened again if the server was restarted.
+ */
+class PlotClient {
+
+private:
+
+    string socketPath;
+    int fd;
+    mutex lock;
+
+    void connectServer();       /**< \brief lock must be held **/
+
+    /**
+     * sends a request and reads the reply, connecting again once if the connection was lost.
+     * @return status of the reply
+     */
+    int request(const uint32_t& kind, const string& script, const string& data, string& payload);
+
+public:
+    explicit PlotClient(const string& socket = defaultServerSocket());
+    ~PlotClient();
+
+    PlotClient(const PlotClient&) = delete;
+    PlotClient& operator=(const PlotClient&) = delete;
+
+    /**
+     * runs script on the server, serverDataSource standing for data.
+     * @return exit status of gnuplot
+     */
+    int run(const string& script, const string& data);
+
+    ServerStats stats();
+
+};
+
+
+#endif //GNUPLOT_PLOTSERVER_H
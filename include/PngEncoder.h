@@ -0,0 +1,39 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_PNGENCODER_H
+#define GNUPLOT_PNGENCODER_H
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * encodes an image as a PNG file in memory, without alpha channel if every pixel is opaque.
+ * Rows are filtered (sub for the first one, up for the others) and compressed with deflate,
+ * fixed Huffman codes and LZ77 matches: fast, and small for plots (large flat areas).
+ * @param rgba width*height pixels, 4 bytes each (red, green, blue, alpha), rows from top to bottom
+ */
+string encodePng(const unsigned char* rgba, const size_t& width, const size_t& height);
+
+/**
+ * writes encodePng(rgba, width, height) to fileName.
+ * @return false if the file could not be written
+ */
+bool writePng(const string& fileName, const unsigned char* rgba, const size_t& width, const size_t& height);
+
+
+#endif //GNUPLOT_PNGENCODER_H
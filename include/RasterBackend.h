@@ -0,0 +1,47 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_RASTERBACKEND_H
+#define GNUPLOT_RASTERBACKEND_H
+
+#include "PlotBackend.h"
+#include "Framebuffer.h"
+
+using namespace std;
+
+/**
+ * Class RasterBackend draws line plots in process and encodes them as png: no gnuplot, no process,
+ * no temporary file. Series are drawn with antialiased lines (and + marks for points) in the colors
+ * of gnuplot line types; axes get a border, ticks on all sides, tick labels, title, axis labels and
+ * a legend in the top right corner. Ranges not set are extended to the next tick, as gnuplot does.
+ *
+ * Only plot options "with lines", "with points" and "with linespoints" (or their abbreviations) are
+ * supported. Render is const on the backend state, so one backend can be used by many threads.
+ */
+class RasterBackend : public PlotBackend {
+
+public:
+    bool canRender(const PlotScene& scene) const override;
+    int render(const PlotScene& scene, const string& fileName) override;
+
+    /**
+     * draws scene in a new framebuffer, i.e. to encode it elsewhere than in a file.
+     */
+    Framebuffer rasterize(const PlotScene& scene) const;
+
+};
+
+
+#endif //GNUPLOT_RASTERBACKEND_H
@@ -0,0 +1,146 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_RENDERCACHE_H
+#define GNUPLOT_RENDERCACHE_H
+
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <streambuf>
+
+using namespace std;
+
+enum class gnuplot_cache_policy{
+
+    GNUPLOT_LRU,        /**< \brief evicts the entries used least recently **/
+    GNUPLOT_FIFO        /**< \brief evicts the entries stored first, hits do not count **/
+
+};
+
+/**
+ * Class Hasher64 computes the 64 bit xxHash (XXH64) of data given in pieces.
+ * It is fast and non cryptographic: good to tell data apart, not to protect it.
+ */
+class Hasher64 {
+
+private:
+
+    uint64_t seed;
+    uint64_t v[4];
+    unsigned char pending[32];
+    size_t nPending;
+    uint64_t total;
+
+    void stripe(const unsigned char* p);
+
+public:
+    explicit Hasher64(const uint64_t& seed = 0);
+
+    void reset(const uint64_t& seed = 0);
+    void update(const void* data, const size_t& length);
+    uint64_t digest() const;
+
+};
+
+/**
+ * Class HashingStreamBuffer passes everything written to another stream buffer, hashing it on the way.
+ */
+class HashingStreamBuffer : public streambuf {
+
+private:
+
+    streambuf* target;
+    Hasher64& hasher;
+
+protected:
+
+    int_type overflow(int_type c) override;
+    streamsize xsputn(const char* s, streamsize n) override;
+    int sync() override;
+
+public:
+    HashingStreamBuffer(streambuf* target, Hasher64& hasher) : target(target), hasher(hasher) {}
+
+};
+
+/**
+ * counters of a RenderCache
+ */
+struct RenderCacheStats {
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t stores = 0;          /**< \brief rendered files copied in the cache **/
+    size_t evictions = 0;
+    size_t bytes = 0;           /**< \brief size of the cache directory **/
+
+};
+
+/**
+ * Class RenderCache keeps the files exported by GnuplotDriver (GNUPLOT_SAVE) in a directory, named after
+ * the hash of the gnuplot script and of the data. If the same plot is exported again the file is taken from
+ * the cache (copied) and gnuplot is not run.
+ * Entries are files, so the cache lasts between runs and can be shared by processes and by drivers.
+ * Exported files and entries are copies of each other: changing one never changes the other.
+ */
+class RenderCache {
+
+private:
+
+    string directory;
+    size_t maxBytes;
+    gnuplot_cache_policy policy;
+    RenderCacheStats counters;
+    mutex lock;
+
+    string entryName(const uint64_t& key, const string& extension) const;
+
+    /**
+     * removes entries, oldest first, until the cache takes at most maxBytes. Lock must be held.
+     */
+    void evict();
+
+public:
+    /**
+     * @param directory cache directory, created if needed
+     * @param maxBytes size limit of the directory, oldest entries are removed beyond it
+     */
+    explicit RenderCache(const string& directory, const size_t& maxBytes = size_t(1) << 30,
+                         const gnuplot_cache_policy& policy = gnuplot_cache_policy::GNUPLOT_LRU);
+
+    RenderCache(const RenderCache&) = delete;
+    RenderCache& operator=(const RenderCache&) = delete;
+
+    /**
+     * if an entry with key exists, puts it in fileName.
+     * @return true on a hit
+     */
+    bool fetch(const uint64_t& key, const string& fileName);
+
+    /**
+     * stores fileName, just rendered, as the entry for key.
+     */
+    void store(const uint64_t& key, const string& fileName);
+
+    void setMaxBytes(const size_t& bytes);
+    void clear();                               /**< \brief removes every entry **/
+    RenderCacheStats stats();
+
+};
+
+
+#endif //GNUPLOT_RENDERCACHE_H
@@ -0,0 +1,82 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_RENDERQUEUE_H
+#define GNUPLOT_RENDERQUEUE_H
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+using namespace std;
+
+enum class gnuplot_queue_policy{
+
+    GNUPLOT_BLOCK,          /**< \brief when the queue is full, push waits for a free slot **/
+    GNUPLOT_DROP_OLDEST     /**< \brief when the queue is full, the oldest pending job is dropped **/
+
+};
+
+/**
+ * Class RenderQueue runs render jobs, one at a time, on a background thread.
+ * At most maxDepth jobs can be pending; what happens when the queue is full depends on the policy.
+ * Every job returns the exit status of gnuplot through a std::future. The future of a dropped
+ * job holds a std::runtime_error instead.
+ *
+ * The destructor waits for pending jobs to be executed.
+ */
+class RenderQueue {
+
+private:
+
+    struct Job {
+        function<int()> run;
+        promise<int> status;
+    };
+
+    deque<Job> jobs;
+    size_t maxDepth;
+    gnuplot_queue_policy policy;
+    bool stopping;
+
+    mutex lock;
+    condition_variable notEmpty;
+    condition_variable notFull;
+    thread worker;
+
+    void work();
+
+public:
+    RenderQueue(size_t maxDepth = 16, gnuplot_queue_policy policy = gnuplot_queue_policy::GNUPLOT_BLOCK);
+    ~RenderQueue();
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    /**
+     * queues job for execution.
+     * @param job function returning the exit status of gnuplot
+     */
+    future<int> push(function<int()> job);
+
+    size_t pending();                   /**< \brief number of jobs waiting to be executed **/
+
+};
+
+
+#endif //GNUPLOT_RENDERQUEUE_H
@@ -0,0 +1,146 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_RETAINEDPLOT_H
+#define GNUPLOT_RETAINEDPLOT_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <functional>
+#include <cstdint>
+#include "GnuplotDriver.h"
+
+using namespace std;
+
+/**
+ * Class RetainedPlot keeps a 2D plot (axes settings, series and their styles) as objects that can be changed
+ * at any time, and a gnuplot session of its own holding what was last rendered. RetainedPlot::render sends only
+ * the settings that changed and the data of the series that changed: data of every series stays in gnuplot,
+ * in a datablock of its own, until the series is changed or removed. Re-rendering after changing a title, a
+ * range or one series out of many costs the plot command only, so parameter sweeps can redraw at every step.
+ *
+ * RetainedPlot plt;
+ * const size_t s = plt.addSeries(x, y, "u(t)");
+ * for (double k : gains) {
+ *     plt.setTitle("k = " + formatNumber(k));
+ *     plt.setData(s, x, response(k));
+ *     plt.render();
+ * }
+ *
+ * If gnuplot is restarted (i.e. after an error in a style) everything is sent again on next render.
+ * An object is meant to be used by one thread at a time.
+ */
+class RetainedPlot {
+
+private:
+
+    struct Series {
+        vector<double> x, y;
+        string title;
+        string style;
+        bool changed;           /**< \brief data set since last render **/
+    };
+
+    gnuplot_action_type action;
+    gnuplot_save_type saveType;
+    string saveName;
+    size_t saveWidth, saveHeight;
+    gnuplot_axis_type axisType;
+    string titleText, xLabelText, yLabelText;
+    int titleFontSize, xLabelFontSize, yLabelFontSize;
+    bool xRangeSet, yRangeSet;
+    double xRangeMin, xRangeMax, yRangeMin, yRangeMax;
+    map<string, string> options;  /**< \brief settings given with RetainedPlot::setOption, by name **/
+
+    map<size_t, Series> series;   /**< \brief series by handle, plotted in order of handle **/
+    size_t nextHandle;
+
+    // state of gnuplot after the last render
+    GnuplotSession session;
+    unsigned long sessionStarts;  /**< \brief GnuplotSession::startCount at last render **/
+    map<string, string> sentSettings; /**< \brief command of every setting, by name **/
+    map<size_t, uint64_t> sentData;   /**< \brief hash of the datablock of every series **/
+    string sentPlot;
+    string sentOutput;
+
+    PlotStats stats;
+
+    Series& find(const size_t& handle, const string& caller);
+
+    /**
+     * command of every setting, by name, as they should be in gnuplot.
+     */
+    map<string, string> settings() const;
+
+    string plotCommand() const;
+    static string blockName(const size_t& handle);
+    static uint64_t hashData(const Series& s);
+
+public:
+    RetainedPlot(gnuplot_action_type action_type = gnuplot_action_type::GNUPLOT_PLOT, string fileName = "plot.png",
+                 gnuplot_save_type format = gnuplot_save_type::GNUPLOT_PNG);
+
+    RetainedPlot(const RetainedPlot&) = delete;
+    RetainedPlot& operator=(const RetainedPlot&) = delete;
+
+    // settings, sent on next render if changed
+    void setTitle(const string& title, const int& fontSize = 0);  /**< \brief font size 0 keeps the default **/
+    void setXLabel(const string& str, const int& fontSize = 20);
+    void setYLabel(const string& str, const int& fontSize = 20);
+    void setXRange(const double& x0, const double& x1);
+    void setYRange(const double& y0, const double& y1);
+    void clearXRange();                                   /**< \brief x range from data again **/
+    void clearYRange();                                   /**< \brief y range from data again **/
+    void setAxisType(const gnuplot_axis_type& axis);
+    void setSaveName(const string& fileName);             /**< \brief file exported if action is GNUPLOT_SAVE **/
+    void setSaveSize(const size_t& width, const size_t& height); /**< \brief size of exported png in pixels **/
+
+    /**
+     * any other gnuplot setting, i.e. setOption("grid", "set grid"). Setting name again replaces it:
+     * to undo a setting give the command restoring it, i.e. setOption("grid", "unset grid").
+     */
+    void setOption(const string& name, const string& command);
+
+    /**
+     * adds a series, copying its data.
+     * @param style gnuplot style, i.e. "with points pt 7"
+     * @return handle of the series
+     */
+    size_t addSeries(const DataView& x, const DataView& y, const string& title = "", const string& style = "with lines");
+
+    void setData(const size_t& handle, const DataView& x, const DataView& y); /**< \brief replaces data of a series **/
+    void setSeriesTitle(const size_t& handle, const string& title);
+    void setSeriesStyle(const size_t& handle, const string& style);
+    void removeSeries(const size_t& handle);
+
+    /**
+     * plots (or saves) the current state, sending gnuplot only what changed since last render.
+     * Data set again with the same values is not sent. If nothing changed nothing is sent.
+     * @return exit status of gnuplot
+     */
+    int render();
+
+    /**
+     * makes next render send everything again, i.e. after the plot window was closed.
+     */
+    void invalidate();
+
+    const PlotStats& lastStats() const { return stats; }  /**< \brief commandBytes counts settings and plot command **/
+
+};
+
+
+#endif //GNUPLOT_RETAINEDPLOT_H
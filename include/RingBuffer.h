@@ -0,0 +1,61 @@
+//============================================================
+//
+//      Type:        simplePlot include file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#ifndef GNUPLOT_RINGBUFFER_H
+#define GNUPLOT_RINGBUFFER_H
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Class RingBuffer holds the last capacity (x, y) samples of a series.
+ * Samples are stored twice, in slot i and slot i + capacity, so that the samples
+ * held are always contiguous in memory, from the oldest to the newest: see RingBuffer::window.
+ */
+class RingBuffer {
+
+private:
+
+    vector<double> data;            /**< \brief 2*capacity interleaved x, y pairs **/
+    size_t cap;
+    unsigned long long pushed;      /**< \brief number of samples pushed so far **/
+
+public:
+    explicit RingBuffer(const size_t& capacity = 1);
+
+    void push(const double& x, const double& y);
+
+    size_t capacity() const { return cap; }
+    size_t size() const { return (pushed < cap) ? (size_t) pushed : cap; }
+    unsigned long long total() const { return pushed; }   /**< \brief samples pushed since construction **/
+
+    /**
+     * returns the slot of the oldest sample held, window() is data() + 2*windowStart()
+     */
+    size_t windowStart() const { return (size_t) ((pushed - size()) % cap); }
+
+    /**
+     * returns the size() samples held as interleaved x, y pairs, oldest first
+     */
+    const double* window() const { return data.data() + 2 * windowStart(); }
+
+    const double* slots() const { return data.data(); }   /**< \brief all the 2*capacity slots **/
+
+};
+
+
+#endif //GNUPLOT_RINGBUFFER_H
@@ -0,0 +1,440 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "DataFile.h"
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ------------------------------------------------------------------------ MappedFile
+
+MappedFile::MappedFile(const string &fileName) {
+
+    this->bytes = nullptr;
+    this->length = 0;
+
+    const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) close(fd);
+        cout<<"\n\n[ERROR] could not open " << fileName << ".\n\n"<<endl;
+        throw std::runtime_error("MappedFile::MappedFile(const string &fileName)");
+    }
+
+    this->length = info.st_size;
+    if (this->length > 0) {
+        void* p = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            cout<<"\n\n[ERROR] could not map " << fileName << " in memory.\n\n"<<endl;
+            throw std::runtime_error("MappedFile::MappedFile(const string &fileName)");
+        }
+        this->bytes = static_cast<const char*>(p);
+    }
+
+    // the mapping keeps the file open
+    close(fd);
+
+}
+
+MappedFile::~MappedFile() {
+
+    if (this->bytes) munmap(const_cast<char*>(this->bytes), this->length);
+
+}
+
+void MappedFile::adviseSequential() const {
+
+    if (this->bytes) madvise(const_cast<char*>(this->bytes), this->length, MADV_SEQUENTIAL);
+
+}
+
+// ------------------------------------------------------------------------ DataFile
+
+static string dtypeFormat(const gnuplot_dtype &dtype) {
+
+    switch (dtype) {
+    case gnuplot_dtype::GNUPLOT_FLOAT32: return "%float32";
+    case gnuplot_dtype::GNUPLOT_INT64: return "%int64";
+    case gnuplot_dtype::GNUPLOT_INT32: return "%int32";
+    case gnuplot_dtype::GNUPLOT_INT16: return "%int16";
+    case gnuplot_dtype::GNUPLOT_UINT8: return "%uint8";
+    case gnuplot_dtype::GNUPLOT_INT8: return "%int8";
+    case gnuplot_dtype::GNUPLOT_UINT16: return "%uint16";
+    case gnuplot_dtype::GNUPLOT_UINT32: return "%uint32";
+    case gnuplot_dtype::GNUPLOT_UINT64: return "%uint64";
+    default: return "%float64";
+    }
+
+}
+
+DataFile::DataFile(const string &fileName, const FileLayout &layout) : file(fileName) {
+
+    this->fileName = fileName;
+    this->layout = layout;
+    if (this->layout.stride == 0) this->layout.stride = 1;
+
+    if (layout.format == gnuplot_data_format::GNUPLOT_BINARY && layout.columns == 0) {
+        cout<<"\n\n[ERROR] binary records of " << fileName << " must have at least one column.\n\n"<<endl;
+        throw std::runtime_error("DataFile::DataFile(const string &fileName, const FileLayout &layout)");
+    }
+
+}
+
+size_t DataFile::records() const {
+
+    const size_t recordSize = this->layout.columns * dtypeSize(this->layout.dtype);
+    if (this->file.size() <= this->layout.skip) return 0;
+    return (this->file.size() - this->layout.skip) / recordSize;
+
+}
+
+void DataFile::forEachRow(const vector<size_t> &columns, const function<void(const double *)> &f) const {
+
+    this->file.adviseSequential();
+
+    if (this->layout.format == gnuplot_data_format::GNUPLOT_BINARY) forEachBinaryRow(columns, f);
+    else forEachTextRow(columns, f);
+
+}
+
+// powers of ten exactly representable as doubles
+static const double exactPowers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// below this many bytes per thread, starting a thread costs more than it saves
+static const size_t minBytesPerThread = 1 << 20;
+
+// strtod on [p, end) only: the text is copied so strtod cannot read past end (strtod skips new lines)
+static const char* strtodWithin(const char* p, const char* end, double& value) {
+
+    char buffer[64];
+    const size_t n = end - p;
+    string copy;
+    const char* text = buffer;
+    if (n < sizeof(buffer)) {
+        memcpy(buffer, p, n);
+        buffer[n] = 0;
+    } else {
+        copy.assign(p, end);
+        text = copy.c_str();
+    }
+
+    char* parsed;
+    value = strtod(text, &parsed);
+    return p + (parsed - text);
+
+}
+
+// reads the number at [p, end) as strtod does, returning where it ends (p if there is no number).
+// Plain decimal numbers of at most 19 significant digits, whose mantissa fits a double and whose
+// exponent is at most 22 in absolute value, are exactly a product or quotient of two exact doubles,
+// so one rounding gives what strtod gives; every other case is left to strtod, never reading past end.
+static const char* parseNumber(const char* p, const char* end, double& value) {
+
+    const char* start = p;
+    const bool negative = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) ++p;
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        any = true;
+        if (mantissa == 0 && *p == '0') continue;
+        if (++digits > 19) break;
+        mantissa = mantissa * 10 + (*p - '0');
+    }
+    if (digits <= 19 && p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            any = true;
+            --exponent;
+            if (mantissa == 0 && *p == '0') continue;
+            if (++digits > 19) break;
+            mantissa = mantissa * 10 + (*p - '0');
+        }
+    }
+
+    // hexadecimal, nan, inf, blanks and longer mantissas are read by strtod
+    if (!any || digits > 19 || (p < end && (*p == 'x' || *p == 'X'))) return strtodWithin(start, end, value);
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        const bool negativeExponent = (e < end && *e == '-');
+        if (e < end && (*e == '-' || *e == '+')) ++e;
+        if (e < end && *e >= '0' && *e <= '9') {
+            int n = 0;
+            for (; e < end && *e >= '0' && *e <= '9'; ++e) if (n < 100000) n = n * 10 + (*e - '0');
+            exponent += negativeExponent ? -n : n;
+            p = e;
+        }
+    }
+
+    if (mantissa == 0) {
+        value = negative ? -0.0 : 0.0;
+        return p;
+    }
+    if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22) return strtodWithin(start, end, value);
+
+    const double v = (exponent < 0) ? mantissa / exactPowers[-exponent] : mantissa * exactPowers[exponent];
+    value = negative ? -v : v;
+    return p;
+
+}
+
+// reads the fields of the line [begin, end) needed by columns in values. Nothing past end is read
+static void parseLine(const char* begin, const char* end, const char& separator,
+                      const vector<size_t>& columns, const size_t& lastColumn,
+                      vector<double>& fields, vector<double>& values) {
+
+    fill(fields.begin(), fields.end(), numeric_limits<double>::quiet_NaN());
+
+    const char* p = begin;
+    for (size_t column = 0; column <= lastColumn && p < end; ++column) {
+        if (separator == 0) while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        if (p >= end) break;
+
+        // the number is looked for in the field only: a blank field is nan, not the next field or line
+        const char* fieldEnd = p;
+        if (separator == 0) {
+            while (fieldEnd < end && *fieldEnd != ' ' && *fieldEnd != '\t') ++fieldEnd;
+        } else {
+            while (fieldEnd < end && *fieldEnd != separator) ++fieldEnd;
+        }
+        const char* first = p;
+        while (first < fieldEnd && (*first == ' ' || *first == '\t' || *first == '\r')) ++first;
+
+        double v;
+        if (first < fieldEnd && parseNumber(first, fieldEnd, v) != first) fields[column] = v;
+
+        // next field
+        p = (separator != 0 && fieldEnd < end) ? fieldEnd + 1 : fieldEnd;
+    }
+
+    for (size_t k = 0; k < columns.size(); ++k) values[k] = fields[columns[k]];
+
+}
+
+// calls row(values) for every row of the text [p, end), comments and blank lines excluded
+template<typename Row>
+static void parseRows(const char* p, const char* end, const char& separator,
+                      const vector<size_t>& columns, const Row& row) {
+
+    const size_t lastColumn = *max_element(columns.begin(), columns.end());
+    vector<double> fields(lastColumn + 1);
+    vector<double> values(columns.size());
+
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        const char* lineEnd = eol ? eol : end;
+        const char* begin = p;
+        p = eol ? eol + 1 : end;
+
+        // comments and blank lines are not rows
+        const char* first = begin;
+        while (first < lineEnd && (*first == ' ' || *first == '\t' || *first == '\r')) ++first;
+        if (first == lineEnd || *first == '#') continue;
+
+        parseLine(begin, lineEnd, separator, columns, lastColumn, fields, values);
+        row(values.data());
+    }
+
+}
+
+const char* DataFile::textBegin() const {
+
+    const char* p = this->file.data();
+    const char* end = p + this->file.size();
+
+    for (size_t line = 0; line < this->layout.skip && p < end; ++line) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        p = eol ? eol + 1 : end;
+    }
+
+    return p;
+
+}
+
+void DataFile::forEachTextRow(const vector<size_t> &columns, const function<void(const double *)> &f) const {
+
+    if (columns.empty()) return;
+
+    size_t row = 0;
+    parseRows(textBegin(), this->file.data() + this->file.size(), this->layout.separator, columns,
+              [&](const double* values) {
+        if (row++ % this->layout.stride == 0) f(values);
+    });
+
+}
+
+size_t DataFile::readColumns(const vector<size_t> &columns, vector<vector<double>> &values, const size_t &threads) const {
+
+    values.assign(columns.size(), vector<double>());
+    if (columns.empty()) return 0;
+
+    if (this->layout.format == gnuplot_data_format::GNUPLOT_BINARY) {
+        const size_t nRows = (records() + this->layout.stride - 1) / this->layout.stride;
+        for (size_t k = 0; k < columns.size(); ++k) values[k].reserve(nRows);
+        forEachBinaryRow(columns, [&](const double* row) {
+            for (size_t k = 0; k < columns.size(); ++k) values[k].push_back(row[k]);
+        });
+        return nRows;
+    }
+
+    this->file.adviseSequential();
+
+    const char* begin = textBegin();
+    const char* end = this->file.data() + this->file.size();
+
+    size_t nThreads = (threads > 0) ? threads : thread::hardware_concurrency();
+    nThreads = std::max<size_t>(1, std::min<size_t>(nThreads, (end - begin) / minBytesPerThread));
+
+    // chunks end after a new line, so that every line is parsed by one thread
+    vector<const char*> bounds(nThreads + 1, end);
+    bounds[0] = begin;
+    for (size_t t = 1; t < nThreads; ++t) {
+        const char* p = std::max(bounds[t - 1], begin + t * (end - begin) / nThreads);
+        const char* eol = (p < end) ? static_cast<const char*>(memchr(p, '\n', end - p)) : nullptr;
+        bounds[t] = eol ? eol + 1 : end;
+    }
+
+    // every row of every chunk is read, the stride is applied when chunks are joined
+    vector<vector<vector<double>>> parts(nThreads, vector<vector<double>>(columns.size()));
+    auto parse = [&](const size_t t) {
+        parseRows(bounds[t], bounds[t + 1], this->layout.separator, columns, [&](const double* row) {
+            for (size_t k = 0; k < columns.size(); ++k) parts[t][k].push_back(row[k]);
+        });
+    };
+
+    vector<thread> workers;
+    for (size_t t = 1; t < nThreads; ++t) workers.push_back(thread(parse, t));
+    parse(0);
+    for (size_t t = 0; t < workers.size(); ++t) workers[t].join();
+
+    const size_t stride = this->layout.stride;
+    if (nThreads == 1 && stride == 1) {
+        values.swap(parts[0]);
+        return values[0].size();
+    }
+
+    size_t nRows = 0;
+    for (size_t t = 0; t < nThreads; ++t) nRows += parts[t][0].size();
+    for (size_t k = 0; k < columns.size(); ++k) values[k].reserve((nRows + stride - 1) / stride);
+
+    size_t row = 0;
+    for (size_t t = 0; t < nThreads; ++t) {
+        const size_t n = parts[t][0].size();
+        for (size_t k = 0; k < columns.size(); ++k) {
+            const vector<double>& part = parts[t][k];
+            if (stride == 1) {
+                values[k].insert(values[k].end(), part.begin(), part.end());
+            } else {
+                for (size_t r = (stride - row % stride) % stride; r < n; r += stride) values[k].push_back(part[r]);
+            }
+            vector<double>().swap(parts[t][k]);
+        }
+        row += n;
+    }
+
+    return values[0].size();
+
+}
+
+// value of type dtype at p, swapping bytes if they are not in host order
+static double readValue(const char* p, const gnuplot_dtype& dtype, const bool& swap) {
+
+    unsigned char b[8];
+    const size_t size = dtypeSize(dtype);
+    memcpy(b, p, size);
+    if (swap) reverse(b, b + size);
+
+    switch (dtype) {
+    case gnuplot_dtype::GNUPLOT_FLOAT32: { float v; memcpy(&v, b, 4); return v; }
+    case gnuplot_dtype::GNUPLOT_INT64: { int64_t v; memcpy(&v, b, 8); return (double) v; }
+    case gnuplot_dtype::GNUPLOT_INT32: { int32_t v; memcpy(&v, b, 4); return v; }
+    case gnuplot_dtype::GNUPLOT_INT16: { int16_t v; memcpy(&v, b, 2); return v; }
+    case gnuplot_dtype::GNUPLOT_UINT8: return b[0];
+    case gnuplot_dtype::GNUPLOT_INT8: { int8_t v; memcpy(&v, b, 1); return v; }
+    case gnuplot_dtype::GNUPLOT_UINT16: { uint16_t v; memcpy(&v, b, 2); return v; }
+    case gnuplot_dtype::GNUPLOT_UINT32: { uint32_t v; memcpy(&v, b, 4); return v; }
+    case gnuplot_dtype::GNUPLOT_UINT64: { uint64_t v; memcpy(&v, b, 8); return (double) v; }
+    default: { double v; memcpy(&v, b, 8); return v; }
+    }
+
+}
+
+void DataFile::forEachBinaryRow(const vector<size_t> &columns, const function<void(const double *)> &f) const {
+
+    for (const size_t& c : columns) {
+        if (c >= this->layout.columns) {
+            cout<<"\n\n[ERROR] column " << c << " is out of the records of " << this->fileName << ".\n\n"<<endl;
+            throw std::runtime_error("void DataFile::forEachBinaryRow(const vector<size_t> &columns, const function<void(const double *)> &f) const");
+        }
+    }
+
+    const size_t valueSize = dtypeSize(this->layout.dtype);
+    const size_t recordSize = this->layout.columns * valueSize;
+    const size_t nRecords = records();
+    const bool swap = (this->layout.littleEndian != hostIsLittleEndian());
+
+    vector<double> values(columns.size());
+    const char* data = this->file.data() + this->layout.skip;
+
+    for (size_t r = 0; r < nRecords; r += this->layout.stride) {
+        const char* record = data + r * recordSize;
+        for (size_t k = 0; k < columns.size(); ++k) values[k] = readValue(record + columns[k] * valueSize, this->layout.dtype, swap);
+        f(values.data());
+    }
+
+}
+
+string DataFile::gnuplotSpec() const {
+
+    string spec;
+
+    if (this->layout.format == gnuplot_data_format::GNUPLOT_BINARY) {
+        string format;
+        for (size_t j = 0; j < this->layout.columns; ++j) format += dtypeFormat(this->layout.dtype);
+        spec += " binary record=(" + to_string(records()) + ")";
+        if (this->layout.skip > 0) spec += " skip=" + to_string(this->layout.skip);
+        spec += " format=\"" + format + "\" endian=" + (this->layout.littleEndian ? "little" : "big");
+    } else if (this->layout.skip > 0) {
+        spec += " skip " + to_string(this->layout.skip);
+    }
+
+    if (this->layout.stride > 1) spec += " every " + to_string(this->layout.stride);
+
+    return spec;
+
+}
+
+string DataFile::separatorCommand() const {
+
+    if (this->layout.format == gnuplot_data_format::GNUPLOT_BINARY || this->layout.separator == 0) return "";
+    if (this->layout.separator == '\t') return "set datafile separator \"\\t\"";
+    return "set datafile separator \"" + string(1, this->layout.separator) + "\"";
+
+}
@@ -0,0 +1,358 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "DataKernels.h"
+#include <cmath>
+#include <cstdint>
+#include <atomic>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SIMPLEPLOT_X86
+#include <immintrin.h>
+#endif
+
+// ------------------------------------------------------------------------ scalar
+
+static inline bool plottable(const double& v, const bool& positiveOnly) {
+
+    // false for nan too
+    return positiveOnly ? (v > 0 && v < HUGE_VAL) : (fabs(v) < HUGE_VAL);
+
+}
+
+static ValueRange valueRangeScalar(const double* values, const size_t& n, const bool& positiveOnly) {
+
+    ValueRange range;
+    for (size_t i = 0; i < n; ++i) {
+        const double v = values[i];
+        if (!plottable(v, positiveOnly)) continue;
+        if (v < range.min) range.min = v;
+        if (v > range.max) range.max = v;
+        ++range.count;
+    }
+    return range;
+
+}
+
+static size_t firstUnplottableScalar(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY) {
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!plottable(x[i], logX) || !plottable(y[i], logY)) return i;
+    }
+    return n;
+
+}
+
+static size_t keepPlottableScalar(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY,
+                                  double* outX, double* outY) {
+
+    size_t kept = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!plottable(x[i], logX) || !plottable(y[i], logY)) continue;
+        outX[kept] = x[i];
+        outY[kept] = y[i];
+        ++kept;
+    }
+    return kept;
+
+}
+
+#ifdef SIMPLEPLOT_X86
+
+// ------------------------------------------------------------------------ SSE2 (every x86-64 cpu)
+
+// all bits set in the lanes holding a value that can be plotted
+static inline __m128d plottableSSE2(const __m128d& v, const bool& positiveOnly) {
+
+    const __m128d absolute = _mm_andnot_pd(_mm_set1_pd(-0.0), v);
+    __m128d mask = _mm_cmplt_pd(absolute, _mm_set1_pd(HUGE_VAL));
+    if (positiveOnly) mask = _mm_and_pd(mask, _mm_cmpgt_pd(v, _mm_setzero_pd()));
+    return mask;
+
+}
+
+// lanes of mask set, lanes of other elsewhere
+static inline __m128d selectSSE2(const __m128d& mask, const __m128d& v, const __m128d& other) {
+
+    return _mm_or_pd(_mm_and_pd(mask, v), _mm_andnot_pd(mask, other));
+
+}
+
+static ValueRange valueRangeSSE2(const double* values, const size_t& n, const bool& positiveOnly) {
+
+    const __m128d inf = _mm_set1_pd(HUGE_VAL);
+    const __m128d minusInf = _mm_set1_pd(-HUGE_VAL);
+
+    // two accumulators, so consecutive min/max do not wait for each other
+    __m128d lo0 = inf, lo1 = inf, hi0 = minusInf, hi1 = minusInf;
+    __m128i count = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128d a = _mm_loadu_pd(values + i);
+        const __m128d b = _mm_loadu_pd(values + i + 2);
+        const __m128d okA = plottableSSE2(a, positiveOnly);
+        const __m128d okB = plottableSSE2(b, positiveOnly);
+        lo0 = _mm_min_pd(lo0, selectSSE2(okA, a, inf));
+        lo1 = _mm_min_pd(lo1, selectSSE2(okB, b, inf));
+        hi0 = _mm_max_pd(hi0, selectSSE2(okA, a, minusInf));
+        hi1 = _mm_max_pd(hi1, selectSSE2(okB, b, minusInf));
+        // a set lane is -1
+        count = _mm_sub_epi64(count, _mm_castpd_si128(okA));
+        count = _mm_sub_epi64(count, _mm_castpd_si128(okB));
+    }
+
+    double lo[2], hi[2];
+    int64_t counts[2];
+    _mm_storeu_pd(lo, _mm_min_pd(lo0, lo1));
+    _mm_storeu_pd(hi, _mm_max_pd(hi0, hi1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(counts), count);
+
+    ValueRange range = valueRangeScalar(values + i, n - i, positiveOnly);
+    const size_t vectorCount = (size_t) (counts[0] + counts[1]);
+    if (vectorCount > 0) {
+        ValueRange vector;
+        vector.min = lo[0] < lo[1] ? lo[0] : lo[1];
+        vector.max = hi[0] > hi[1] ? hi[0] : hi[1];
+        vector.count = vectorCount;
+        range.merge(vector);
+    }
+    return range;
+
+}
+
+static size_t firstUnplottableSSE2(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY) {
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d ok = _mm_and_pd(plottableSSE2(_mm_loadu_pd(x + i), logX), plottableSSE2(_mm_loadu_pd(y + i), logY));
+        const int mask = _mm_movemask_pd(ok);
+        if (mask != 0x3) return i + ((mask & 1) ? 1 : 0);
+    }
+    return i + firstUnplottableScalar(x + i, y + i, n - i, logX, logY);
+
+}
+
+static size_t keepPlottableSSE2(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY,
+                                double* outX, double* outY) {
+
+    size_t kept = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d vx = _mm_loadu_pd(x + i);
+        const __m128d vy = _mm_loadu_pd(y + i);
+        const int mask = _mm_movemask_pd(_mm_and_pd(plottableSSE2(vx, logX), plottableSSE2(vy, logY)));
+        if (mask == 0x3) {
+            _mm_storeu_pd(outX + kept, vx);
+            _mm_storeu_pd(outY + kept, vy);
+            kept += 2;
+            continue;
+        }
+        for (int l = 0; l < 2; ++l) {
+            if (!(mask & (1 << l))) continue;
+            outX[kept] = x[i + l];
+            outY[kept] = y[i + l];
+            ++kept;
+        }
+    }
+    return kept + keepPlottableScalar(x + i, y + i, n - i, logX, logY, outX + kept, outY + kept);
+
+}
+
+// ------------------------------------------------------------------------ AVX2
+
+__attribute__((target("avx2")))
+static inline __m256d plottableAVX2(const __m256d& v, const bool& positiveOnly) {
+
+    const __m256d absolute = _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+    __m256d mask = _mm256_cmp_pd(absolute, _mm256_set1_pd(HUGE_VAL), _CMP_LT_OQ);
+    if (positiveOnly) mask = _mm256_and_pd(mask, _mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_GT_OQ));
+    return mask;
+
+}
+
+__attribute__((target("avx2")))
+static ValueRange valueRangeAVX2(const double* values, const size_t& n, const bool& positiveOnly) {
+
+    const __m256d inf = _mm256_set1_pd(HUGE_VAL);
+    const __m256d minusInf = _mm256_set1_pd(-HUGE_VAL);
+
+    // four accumulators hide the latency of min/max: the loop is then bound by memory
+    __m256d lo[4] = {inf, inf, inf, inf};
+    __m256d hi[4] = {minusInf, minusInf, minusInf, minusInf};
+    __m256i count[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        for (int k = 0; k < 4; ++k) {
+            const __m256d a = _mm256_loadu_pd(values + i + 4 * k);
+            const __m256d ok = plottableAVX2(a, positiveOnly);
+            lo[k] = _mm256_min_pd(lo[k], _mm256_blendv_pd(inf, a, ok));
+            hi[k] = _mm256_max_pd(hi[k], _mm256_blendv_pd(minusInf, a, ok));
+            count[k] = _mm256_sub_epi64(count[k], _mm256_castpd_si256(ok));
+        }
+    }
+
+    double los[4], his[4];
+    int64_t counts[4];
+    _mm256_storeu_pd(los, _mm256_min_pd(_mm256_min_pd(lo[0], lo[1]), _mm256_min_pd(lo[2], lo[3])));
+    _mm256_storeu_pd(his, _mm256_max_pd(_mm256_max_pd(hi[0], hi[1]), _mm256_max_pd(hi[2], hi[3])));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(counts),
+                        _mm256_add_epi64(_mm256_add_epi64(count[0], count[1]), _mm256_add_epi64(count[2], count[3])));
+
+    ValueRange range = valueRangeScalar(values + i, n - i, positiveOnly);
+    const size_t vectorCount = (size_t) (counts[0] + counts[1] + counts[2] + counts[3]);
+    if (vectorCount > 0) {
+        ValueRange vector;
+        vector.min = los[0];
+        vector.max = his[0];
+        for (int l = 1; l < 4; ++l) {
+            if (los[l] < vector.min) vector.min = los[l];
+            if (his[l] > vector.max) vector.max = his[l];
+        }
+        vector.count = vectorCount;
+        range.merge(vector);
+    }
+    return range;
+
+}
+
+__attribute__((target("avx2")))
+static size_t firstUnplottableAVX2(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY) {
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d ok = _mm256_and_pd(plottableAVX2(_mm256_loadu_pd(x + i), logX), plottableAVX2(_mm256_loadu_pd(y + i), logY));
+        const int mask = _mm256_movemask_pd(ok);
+        if (mask != 0xF) return i + __builtin_ctz(~mask & 0xF);
+    }
+    return i + firstUnplottableScalar(x + i, y + i, n - i, logX, logY);
+
+}
+
+__attribute__((target("avx2")))
+static size_t keepPlottableAVX2(const double* x, const double* y, const size_t& n, const bool& logX, const bool& logY,
+                                double* outX, double* outY) {
+
+    size_t kept = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d vx = _mm256_loadu_pd(x + i);
+        const __m256d vy = _mm256_loadu_pd(y + i);
+        const int mask = _mm256_movemask_pd(_mm256_and_pd(plottableAVX2(vx, logX), plottableAVX2(vy, logY)));
+        if (mask == 0xF) {
+            _mm256_storeu_pd(outX + kept, vx);
+            _mm256_storeu_pd(outY + kept, vy);
+            kept += 4;
+            continue;
+        }
+        for (int l = 0; l < 4; ++l) {
+            if (!(mask & (1 << l))) continue;
+            outX[kept] = x[i + l];
+            outY[kept] = y[i + l];
+            ++kept;
+        }
+    }
+    return kept + keepPlottableScalar(x + i, y + i, n - i, logX, logY, outX + kept, outY + kept);
+
+}
+
+#endif
+
+// ------------------------------------------------------------------------ dispatch
+
+static gnuplot_simd detectSimd() {
+
+#ifdef SIMPLEPLOT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return gnuplot_simd::GNUPLOT_AVX2;
+    return gnuplot_simd::GNUPLOT_SSE2;
+#else
+    return gnuplot_simd::GNUPLOT_SCALAR;
+#endif
+
+}
+
+static atomic<int>& currentLevel() {
+
+    static atomic<int> level((int) detectSimd());
+    return level;
+
+}
+
+gnuplot_simd simdLevel() {
+
+    return (gnuplot_simd) currentLevel().load(memory_order_relaxed);
+
+}
+
+void setSimdLevel(const gnuplot_simd &level) {
+
+    const int best = (int) detectSimd();
+    currentLevel().store((int) level < best ? (int) level : best, memory_order_relaxed);
+
+}
+
+ValueRange valueRange(const double *values, const size_t &n, const bool &positiveOnly) {
+
+    switch (simdLevel()) {
+#ifdef SIMPLEPLOT_X86
+    case gnuplot_simd::GNUPLOT_AVX2: return valueRangeAVX2(values, n, positiveOnly);
+    case gnuplot_simd::GNUPLOT_SSE2: return valueRangeSSE2(values, n, positiveOnly);
+#endif
+    default: return valueRangeScalar(values, n, positiveOnly);
+    }
+
+}
+
+size_t firstUnplottable(const double *x, const double *y, const size_t &n, const bool &logX, const bool &logY) {
+
+    switch (simdLevel()) {
+#ifdef SIMPLEPLOT_X86
+    case gnuplot_simd::GNUPLOT_AVX2: return firstUnplottableAVX2(x, y, n, logX, logY);
+    case gnuplot_simd::GNUPLOT_SSE2: return firstUnplottableSSE2(x, y, n, logX, logY);
+#endif
+    default: return firstUnplottableScalar(x, y, n, logX, logY);
+    }
+
+}
+
+size_t keepPlottable(const double *x, const double *y, const size_t &n, const bool &logX, const bool &logY,
+                     double *outX, double *outY) {
+
+    switch (simdLevel()) {
+#ifdef SIMPLEPLOT_X86
+    case gnuplot_simd::GNUPLOT_AVX2: return keepPlottableAVX2(x, y, n, logX, logY, outX, outY);
+    case gnuplot_simd::GNUPLOT_SSE2: return keepPlottableSSE2(x, y, n, logX, logY, outX, outY);
+#endif
+    default: return keepPlottableScalar(x, y, n, logX, logY, outX, outY);
+    }
+
+}
+
+ValueRange valueRange(const DataView &values, const bool &positiveOnly) {
+
+    const double* contiguous = values.doubles();
+    if (contiguous) return valueRange(contiguous, values.size(), positiveOnly);
+
+    ValueRange range;
+    double buffer[DataView::chunkSize];
+    for (size_t start = 0; start < values.size(); start += DataView::chunkSize) {
+        const size_t count = (values.size() - start < DataView::chunkSize) ? values.size() - start : DataView::chunkSize;
+        range.merge(valueRange(values.read(start, count, buffer), count, positiveOnly));
+    }
+    return range;
+
+}
@@ -0,0 +1,93 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "DataView.h"
+#include <cstdint>
+
+const size_t DataView::chunkSize;
+
+size_t dtypeSize(const gnuplot_dtype &dtype) {
+
+    switch (dtype) {
+    case gnuplot_dtype::GNUPLOT_FLOAT32: return 4;
+    case gnuplot_dtype::GNUPLOT_INT32: return 4;
+    case gnuplot_dtype::GNUPLOT_UINT32: return 4;
+    case gnuplot_dtype::GNUPLOT_INT16: return 2;
+    case gnuplot_dtype::GNUPLOT_UINT16: return 2;
+    case gnuplot_dtype::GNUPLOT_INT8: return 1;
+    case gnuplot_dtype::GNUPLOT_UINT8: return 1;
+    default: return 8;
+    }
+
+}
+
+// count values of type T from p, stride bytes apart, as doubles in out
+template<typename T>
+static void convertValues(const char* p, const size_t& stride, const size_t& count, double* out) {
+
+    for (size_t i = 0; i < count; ++i) {
+        T v;
+        memcpy(&v, p + i * stride, sizeof(T));
+        out[i] = (double) v;
+    }
+
+}
+
+static void convertValues(const char* p, const size_t& stride, const gnuplot_dtype& type, const size_t& count, double* out) {
+
+    switch (type) {
+    case gnuplot_dtype::GNUPLOT_FLOAT32: convertValues<float>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_INT64: convertValues<int64_t>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_INT32: convertValues<int32_t>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_INT16: convertValues<int16_t>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_INT8: convertValues<int8_t>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_UINT64: convertValues<uint64_t>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_UINT32: convertValues<uint32_t>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_UINT16: convertValues<uint16_t>(p, stride, count, out); break;
+    case gnuplot_dtype::GNUPLOT_UINT8: convertValues<uint8_t>(p, stride, count, out); break;
+    default: convertValues<double>(p, stride, count, out); break;
+    }
+
+}
+
+double DataView::convert(const size_t &i) const {
+
+    double v;
+    convertValues(this->base + i * this->stride, this->stride, this->type, 1, &v);
+    return v;
+
+}
+
+const double *DataView::read(const size_t &first, const size_t &count, double *buffer) const {
+
+    const double* values = doubles();
+    if (values) return values + first;
+
+    convertValues(this->base + first * this->stride, this->stride, this->type, count, buffer);
+    return buffer;
+
+}
+
+void DataView::copyTo(double *out) const {
+
+    const double* values = doubles();
+    if (values) {
+        if (this->n > 0) memcpy(out, values, this->n * sizeof(double));
+        return;
+    }
+
+    convertValues(this->base, this->stride, this->type, this->n, out);
+
+}
@@ -0,0 +1,491 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "Decimation.h"
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static inline double axisValue(const double& v, const bool& log) {
+
+    return log ? log10(v) : v;
+
+}
+
+/**
+ * finds the points to be kept: [first, last) holds every x in [xMin, xMax] and its two neighbours.
+ * @return false if x is not sorted
+ */
+static bool visibleRange(const DataView& x, const double& xMin, const double& xMax, const bool& logX,
+                         size_t& first, size_t& last) {
+
+    const size_t n = x.size();
+
+    double previous = (n > 0) ? x[0] : 0;
+    for (size_t i = 1; i < n; ++i) {
+        const double v = x[i];
+        if (v < previous) return false;
+        previous = v;
+    }
+
+    // first x >= xMin and first x > xMax, x being sorted
+    first = n;
+    last = n;
+    for (size_t lo = 0, hi = n; lo < hi; ) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (x[mid] < xMin) lo = mid + 1;
+        else hi = first = mid;
+    }
+    for (size_t lo = first, hi = n; lo < hi; ) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (x[mid] <= xMax) lo = mid + 1;
+        else hi = last = mid;
+    }
+
+    if (first > 0 && (!logX || x[first-1] > 0)) --first;
+    if (last < n) ++last;
+
+    return true;
+
+}
+
+// copies [first, last) of view in out
+static void assignRange(const DataView& view, const size_t& first, const size_t& last, vector<double>& out) {
+
+    out.resize(last - first);
+    for (size_t i = first; i < last; ++i) out[i - first] = view[i];
+
+}
+
+MinMaxStream::MinMaxStream(const double &xMin, const double &xMax, const bool &logX, const size_t &nColumns) {
+
+    this->xMin = xMin;
+    this->xMax = xMax;
+    this->logX = logX;
+    this->nColumns = nColumns;
+    this->x0 = axisValue(xMin, logX);
+    const double x1 = axisValue(xMax, logX);
+    this->scale = (x1 > this->x0) ? nColumns / (x1 - this->x0) : 0;
+
+    this->column = -1;
+    this->count = 0;
+    this->hasBefore = false;
+    this->afterWritten = false;
+    this->sorted = true;
+    this->previousX = -numeric_limits<double>::infinity();
+
+}
+
+void MinMaxStream::push(const double &x, const double &y) {
+
+    this->outX.push_back(x);
+    this->outY.push_back(y);
+
+}
+
+void MinMaxStream::flush() {
+
+    if (this->column < 0) return;
+
+    // points are written in their original order, so lines are drawn as without decimation
+    Point p[4] = {this->first, this->lowest, this->highest, this->last};
+    sort(p, p + 4, [](const Point& a, const Point& b) { return a.n < b.n; });
+    for (int k = 0; k < 4; ++k) {
+        if (k == 0 || p[k].n != p[k-1].n) push(p[k].x, p[k].y);
+    }
+    this->column = -1;
+
+}
+
+void MinMaxStream::add(const double &x, const double &y) {
+
+    if (x < this->previousX) this->sorted = false;
+    this->previousX = x;
+    const size_t n = this->count++;
+
+    if (this->logX && x <= 0) return;
+
+    if (x < this->xMin) {
+        // only the last point before the range is kept
+        this->hasBefore = true;
+        this->before.n = n;
+        this->before.x = x;
+        this->before.y = y;
+        return;
+    }
+    if (this->hasBefore) {
+        push(this->before.x, this->before.y);
+        this->hasBefore = false;
+    }
+    if (x > this->xMax) {
+        // only the first point after the range is kept
+        flush();
+        if (!this->afterWritten) push(x, y);
+        this->afterWritten = true;
+        return;
+    }
+
+    long c = (long) ((axisValue(x, this->logX) - this->x0) * this->scale);
+    if (c >= (long) this->nColumns) c = this->nColumns - 1;
+
+    const Point p = {n, x, y};
+    if (c != this->column) {
+        flush();
+        this->column = c;
+        this->first = this->last = this->lowest = this->highest = p;
+    } else {
+        this->last = p;
+        // nan is neither min nor max: a column started by nan takes its first y that is not
+        const bool unset = std::isnan(this->lowest.y) && !std::isnan(y);
+        if (y < this->lowest.y || unset) this->lowest = p;
+        if (y > this->highest.y || unset) this->highest = p;
+    }
+
+}
+
+bool MinMaxStream::finish(vector<double> &x, vector<double> &y) {
+
+    flush();
+    if (this->hasBefore) push(this->before.x, this->before.y);
+    this->hasBefore = false;
+
+    x.swap(this->outX);
+    y.swap(this->outY);
+    this->outX.clear();
+    this->outY.clear();
+
+    return this->sorted;
+
+}
+
+bool decimateMinMax(const DataView &x, const DataView &y,
+                    const double &xMin, const double &xMax, const bool &logX, const size_t &nColumns,
+                    vector<double> &outX, vector<double> &outY) {
+
+    outX.clear();
+    outY.clear();
+
+    size_t first, last;
+    if (!visibleRange(x, xMin, xMax, logX, first, last)) {
+        assignRange(x, 0, x.size(), outX);
+        assignRange(y, 0, y.size(), outY);
+        return false;
+    }
+
+    MinMaxStream stream(xMin, xMax, logX, nColumns);
+    for (size_t i = first; i < last; ++i) stream.add(x[i], y[i]);
+    stream.finish(outX, outY);
+
+    return true;
+
+}
+
+const size_t MinMaxPyramid::blockSize;
+const size_t MinMaxPyramid::fanOut;
+const size_t MinMaxPyramid::npos;
+
+MinMaxPyramid::Node MinMaxPyramid::emptyNode() {
+
+    Node node;
+    node.min = numeric_limits<double>::infinity();
+    node.max = -numeric_limits<double>::infinity();
+    node.iMin = node.iMax = npos;
+
+    return node;
+
+}
+
+void MinMaxPyramid::merge(const double &value, const size_t &i, MinMaxPyramid::Node &node) {
+
+    // nan is neither min nor max; points are not always merged in order, so ties go to the first one
+    if (value < node.min || (value == node.min && i < node.iMin)) {
+        node.min = value;
+        node.iMin = i;
+    }
+    if (value > node.max || (value == node.max && i < node.iMax)) {
+        node.max = value;
+        node.iMax = i;
+    }
+
+}
+
+void MinMaxPyramid::merge(const MinMaxPyramid::Node &other, MinMaxPyramid::Node &node) {
+
+    if (other.iMin != npos && (other.min < node.min || (other.min == node.min && other.iMin < node.iMin))) {
+        node.min = other.min;
+        node.iMin = other.iMin;
+    }
+    if (other.iMax != npos && (other.max > node.max || (other.max == node.max && other.iMax < node.iMax))) {
+        node.max = other.max;
+        node.iMax = other.iMax;
+    }
+
+}
+
+MinMaxPyramid::MinMaxPyramid(const DataView &x, const DataView &y) {
+
+    if (x.size() != y.size()) {
+        cout<<"\n\n[ERROR] x and y must have same dimension.\n\n"<<endl;
+        throw std::runtime_error("MinMaxPyramid::MinMaxPyramid(const DataView &x, const DataView &y)");
+    }
+
+    this->x = x;
+    this->y = y;
+    this->sorted = true;
+
+    const size_t n = x.size();
+    const size_t chunk = DataView::chunkSize;
+    double bufferX[DataView::chunkSize], bufferY[DataView::chunkSize];
+    double previous = -numeric_limits<double>::infinity();
+
+    // first level and the order of x in one pass, a chunk (a whole number of blocks) at a time
+    vector<Node> blocks((n + blockSize - 1) / blockSize, emptyNode());
+    for (size_t start = 0; start < n; start += chunk) {
+        const size_t count = std::min(chunk, n - start);
+        const double* xs = x.read(start, count, bufferX);
+        const double* ys = y.read(start, count, bufferY);
+
+        for (size_t k = 0; k < count; ++k) {
+            if (xs[k] < previous) this->sorted = false;
+            previous = xs[k];
+            merge(ys[k], start + k, blocks[(start + k) / blockSize]);
+        }
+    }
+    this->levels.push_back(move(blocks));
+
+    // every level merges fanOut nodes of the one below, up to a level small enough to be scanned
+    while (this->levels.back().size() > fanOut) {
+        const vector<Node>& below = this->levels.back();
+        vector<Node> above((below.size() + fanOut - 1) / fanOut, emptyNode());
+        for (size_t k = 0; k < below.size(); ++k) merge(below[k], above[k / fanOut]);
+        this->levels.push_back(move(above));
+    }
+
+}
+
+void MinMaxPyramid::scan(const size_t &first, const size_t &last, MinMaxPyramid::Node &node) const {
+
+    double buffer[DataView::chunkSize];
+    for (size_t start = first; start < last; start += DataView::chunkSize) {
+        const size_t count = std::min(DataView::chunkSize, last - start);
+        const double* ys = this->y.read(start, count, buffer);
+        for (size_t k = 0; k < count; ++k) merge(ys[k], start + k, node);
+    }
+
+}
+
+MinMaxPyramid::Node MinMaxPyramid::extremes(size_t first, size_t last) const {
+
+    Node node = emptyNode();
+
+    // points outside whole blocks are read from the series
+    size_t a = (first + blockSize - 1) / blockSize;
+    size_t b = last / blockSize;
+    if (a >= b) {
+        scan(first, last, node);
+        return node;
+    }
+    scan(first, a * blockSize, node);
+    scan(b * blockSize, last, node);
+
+    // blocks [a, b) of level k: the ones outside whole nodes of level k+1 are merged here, the others above
+    for (size_t k = 0; ; ++k) {
+        const vector<Node>& level = this->levels[k];
+        const size_t a2 = (a + fanOut - 1) / fanOut;
+        const size_t b2 = b / fanOut;
+        if (k + 1 == this->levels.size() || a2 >= b2) {
+            for (size_t j = a; j < b; ++j) merge(level[j], node);
+            break;
+        }
+        for (size_t j = a; j < a2 * fanOut; ++j) merge(level[j], node);
+        for (size_t j = b2 * fanOut; j < b; ++j) merge(level[j], node);
+        a = a2;
+        b = b2;
+    }
+
+    return node;
+
+}
+
+ValueRange MinMaxPyramid::xRange(const bool &positiveOnly) const {
+
+    ValueRange range;
+    const size_t n = this->x.size();
+
+    // first positive x
+    size_t first = 0;
+    if (positiveOnly) {
+        for (size_t lo = 0, hi = n; lo < hi; ) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (this->x[mid] <= 0) lo = first = mid + 1;
+            else hi = mid;
+        }
+    }
+
+    if (first < n && this->x[first] <= this->x[n-1]) {
+        range.min = this->x[first];
+        range.max = this->x[n-1];
+        range.count = n - first;
+    }
+
+    return range;
+
+}
+
+bool MinMaxPyramid::decimate(const double &xMin, const double &xMax, const bool &logX, const size_t &nColumns,
+                             vector<double> &outX, vector<double> &outY) const {
+
+    outX.clear();
+    outY.clear();
+
+    const DataView& x = this->x;
+    const DataView& y = this->y;
+    const size_t n = x.size();
+
+    if (!this->sorted) {
+        assignRange(x, 0, n, outX);
+        assignRange(y, 0, n, outY);
+        return false;
+    }
+
+    // first x >= xMin and first x > xMax
+    size_t first = n, last = n;
+    for (size_t lo = 0, hi = n; lo < hi; ) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (x[mid] < xMin) lo = mid + 1;
+        else hi = first = mid;
+    }
+    for (size_t lo = first, hi = n; lo < hi; ) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (x[mid] <= xMax) lo = mid + 1;
+        else hi = last = mid;
+    }
+
+    // pixel columns as in MinMaxStream
+    const double x0 = axisValue(xMin, logX);
+    const double x1 = axisValue(xMax, logX);
+    const double scale = (x1 > x0) ? nColumns / (x1 - x0) : 0;
+    auto column = [&](const size_t& i) {
+        const long c = (long) ((axisValue(x[i], logX) - x0) * scale);
+        return (c >= (long) nColumns) ? (long) nColumns - 1 : c;
+    };
+
+    auto push = [&](const size_t& i) {
+        outX.push_back(x[i]);
+        outY.push_back(y[i]);
+    };
+
+    // neighbours of the range, so lines enter and leave the plot with the right slope
+    if (first > 0 && (!logX || x[first-1] > 0)) push(first - 1);
+
+    for (size_t i = first; i < last; ) {
+        // points of column c end at the first one in a column on its right
+        const long c = column(i);
+        size_t end = last;
+        for (size_t lo = i + 1, hi = last; lo < hi; ) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (column(mid) <= c) lo = mid + 1;
+            else hi = end = mid;
+        }
+
+        const Node node = extremes(i, end);
+        size_t p[4] = {i, node.iMin != npos ? node.iMin : i, node.iMax != npos ? node.iMax : i, end - 1};
+        sort(p, p + 4);
+        for (int k = 0; k < 4; ++k) {
+            if (k == 0 || p[k] != p[k-1]) push(p[k]);
+        }
+
+        i = end;
+    }
+
+    if (last < n) push(last);
+
+    return true;
+
+}
+
+bool decimateLTTB(const DataView &x, const DataView &y,
+                  const double &xMin, const double &xMax, const bool &logX, const bool &logY, const size_t &nPoints,
+                  vector<double> &outX, vector<double> &outY) {
+
+    outX.clear();
+    outY.clear();
+
+    size_t first, last;
+    if (!visibleRange(x, xMin, xMax, logX, first, last)) {
+        assignRange(x, 0, x.size(), outX);
+        assignRange(y, 0, y.size(), outY);
+        return false;
+    }
+
+    const size_t n = last - first;
+
+    if (n <= nPoints || nPoints < 3) {
+        assignRange(x, first, last, outX);
+        assignRange(y, first, last, outY);
+        return true;
+    }
+
+    outX.reserve(nPoints);
+    outY.reserve(nPoints);
+
+    // first and last points are always kept, the others are split in nPoints-2 buckets
+    const double bucket = (double) (n - 2) / (nPoints - 2);
+
+    size_t a = first;
+    outX.push_back(x[a]);
+    outY.push_back(y[a]);
+
+    for (size_t b = 0; b < nPoints - 2; ++b) {
+        const size_t start = first + 1 + (size_t) (b * bucket);
+        const size_t end = first + 1 + (size_t) ((b + 1) * bucket);
+        const size_t nextEnd = min(first + 1 + (size_t) ((b + 2) * bucket), last);
+
+        // average of the next bucket (the last point for the last bucket)
+        double avgX = 0, avgY = 0;
+        for (size_t i = end; i < nextEnd; ++i) {
+            avgX += axisValue(x[i], logX);
+            avgY += axisValue(y[i], logY);
+        }
+        avgX /= (nextEnd - end);
+        avgY /= (nextEnd - end);
+
+        const double ax = axisValue(x[a], logX);
+        const double ay = axisValue(y[a], logY);
+
+        size_t best = start;
+        double maxArea = -1;
+        for (size_t i = start; i < end; ++i) {
+            const double area = fabs((ax - avgX) * (axisValue(y[i], logY) - ay) -
+                                     (ax - axisValue(x[i], logX)) * (avgY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                best = i;
+            }
+        }
+
+        outX.push_back(x[best]);
+        outY.push_back(y[best]);
+        a = best;
+    }
+
+    outX.push_back(x[last - 1]);
+    outY.push_back(y[last - 1]);
+
+    return true;
+
+}
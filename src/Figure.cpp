@@ -0,0 +1,289 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "Figure.h"
+#include "NumberFormat.h"
+#include <iostream>
+#include <stdexcept>
+
+// settings a panel may have changed, restored before the next panel. "reset" cannot be used:
+// it would also undo the size and origin set by the multiplot layout
+static const char* panelDefaults =
+        "set title \"\" font \"\"\n"
+        "set xlabel \"\" font \"\"\n"
+        "set ylabel \"\" font \"\"\n"
+        "set autoscale xy\n"
+        "unset logscale\n"
+        "set key\n";
+
+Figure::Figure(const size_t &rows, const size_t &cols, gnuplot_action_type action_type, string fileName, gnuplot_save_type format)
+        : page(gnuplot_axis_type::GNUPLOT_LINEAR, action_type, fileName, format) {
+
+    if (rows == 0 || cols == 0) {
+        cout<<"\n\n[ERROR] a figure needs at least one row and one column.\n\n"<<endl;
+        throw std::runtime_error("Figure::Figure(const size_t &rows, const size_t &cols, gnuplot_action_type action_type, string fileName, gnuplot_save_type format)");
+    }
+    if (action_type == gnuplot_action_type::GNUPLOT_VIDEO) {
+        cout<<"\n\n[ERROR] a figure can only be plotted or saved.\n\n"<<endl;
+        throw std::runtime_error("Figure::Figure(const size_t &rows, const size_t &cols, gnuplot_action_type action_type, string fileName, gnuplot_save_type format)");
+    }
+
+    this->rows = rows;
+    this->cols = cols;
+    this->width = 0;
+    this->height = 0;
+
+    for (size_t p = 0; p < rows * cols; ++p) {
+        this->panels.push_back(unique_ptr<GnuplotDriver>(new GnuplotDriver()));
+    }
+    this->panelX.resize(rows * cols);
+    this->panelY.resize(rows * cols);
+
+}
+
+size_t Figure::index(const size_t &row, const size_t &col) const {
+
+    if (row >= this->rows || col >= this->cols) {
+        cout<<"\n\n[ERROR] panel (" << row << ", " << col << ") is out of the figure layout.\n\n"<<endl;
+        throw std::runtime_error("size_t Figure::index(const size_t &row, const size_t &col) const");
+    }
+
+    return row * this->cols + col;
+
+}
+
+GnuplotDriver &Figure::panel(const size_t &row, const size_t &col) {
+
+    return *this->panels[index(row, col)];
+
+}
+
+void Figure::plot(const size_t &row, const size_t &col, const vector<double> &x, const vector<double> &y) {
+
+    plot(row, col, DataView(x), DataView(y));
+
+}
+
+void Figure::plot(const size_t &row, const size_t &col, const DataView &x, const DataView &y) {
+
+    if(x.size() != y.size()){
+        cout<<"\n\n[ERROR] x and y must have same dimension.\n\n"<<endl;
+        throw std::runtime_error("void Figure::plot(const size_t &row, const size_t &col, const DataView &x, const DataView &y)");
+    }
+
+    // the figure is rendered later: data is copied
+    const size_t p = index(row, col);
+    this->panelX[p].assign(1, vector<double>(x.size()));
+    this->panelY[p].assign(1, vector<double>(y.size()));
+    x.copyTo(this->panelX[p][0].data());
+    y.copyTo(this->panelY[p][0].data());
+
+}
+
+void Figure::plot(const size_t &row, const size_t &col, const vector<vector<double>> &x, const vector<vector<double>> &y) {
+
+    if(x.empty() || x.size() != y.size()){
+        cout<<"\n\n[ERROR] x and y must have same number of series.\n\n"<<endl;
+        throw std::runtime_error("void Figure::plot(const size_t &row, const size_t &col, const vector<vector<double>> &x, const vector<vector<double>> &y)");
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+        if(x[i].size() != y[i].size()){
+            cout<<"\n\n[ERROR] x" << i << " and y" << i << " must have same dimension.\n\n"<<endl;
+            throw std::runtime_error("void Figure::plot(const size_t &row, const size_t &col, const vector<vector<double>> &x, const vector<vector<double>> &y)");
+        }
+    }
+
+    const size_t p = index(row, col);
+    this->panelX[p] = x;
+    this->panelY[p] = y;
+
+}
+
+void Figure::clear() {
+
+    for (size_t p = 0; p < this->panels.size(); ++p) {
+        this->panelX[p].clear();
+        this->panelY[p].clear();
+    }
+
+}
+
+void Figure::setTitle(const string &str) {
+
+    this->title = str;
+
+}
+
+void Figure::setSize(const size_t &w, const size_t &h) {
+
+    this->width = w;
+    this->height = h;
+
+}
+
+void Figure::setSaveName(const string &fileName) {
+
+    this->page.setSaveName(fileName);
+
+}
+
+void Figure::setDataFormat(const gnuplot_data_format &format) {
+
+    this->page.setDataFormat(format);
+
+}
+
+void Figure::setDataTransport(const gnuplot_data_transport &transport) {
+
+    this->page.setDataTransport(transport);
+
+}
+
+void Figure::setPrecision(const int &digits) {
+
+    this->page.setPrecision(digits);
+
+}
+
+void Figure::setRenderCache(const shared_ptr<RenderCache> &cache) {
+
+    this->page.setRenderCache(cache);
+
+}
+
+void Figure::setStats(const bool &enabled, const function<void(const PlotStats&)> &callback) {
+
+    this->page.setStats(enabled, callback);
+
+}
+
+const PlotStats &Figure::lastStats() const {
+
+    return this->page.lastStats();
+
+}
+
+void Figure::setSession(const shared_ptr<GnuplotSession> &s) {
+
+    this->page.setSession(s);
+
+}
+
+string Figure::write_action_save() const {
+
+    string lines;
+    const bool sized = this->width > 0 && this->height > 0;
+
+    switch(this->page.saveType){
+    case gnuplot_save_type::GNUPLOT_EPS:
+        lines += "set term epscairo";
+        if (sized) lines += " size " + formatNumber(this->width / 100.0) + "," + formatNumber(this->height / 100.0);
+        break;
+    case gnuplot_save_type::GNUPLOT_PNG:
+        lines += "set term png";
+        if (sized) lines += " size " + to_string(this->width) + "," + to_string(this->height);
+        break;
+    default:
+        cout<<"\n\n[ERROR] wrong output file type.\n\n"<<endl;
+        throw std::runtime_error("string Figure::write_action_save() const");
+    }
+
+    lines += "\nset output \"" + this->page.saveName + "\"\n";
+
+    return lines;
+
+}
+
+int Figure::render() {
+
+    if(this->page.action == gnuplot_action_type::GNUPLOT_NONE){
+        cout << "[WARNING] gnuplot action is set to GNUPLOT_NONE." << endl;
+        return 0;
+    }
+
+    const size_t nPanels = this->panels.size();
+
+    // series of every panel, filtered and decimated with the settings of the panel
+    vector<vector<DataView>> x(nPanels), y(nPanels);
+    vector<vector<vector<double>>> plottableX(nPanels), plottableY(nPanels);
+    vector<vector<vector<double>>> decimatedX(nPanels), decimatedY(nPanels);
+    vector<DataView> allX, allY;
+
+    for (size_t p = 0; p < nPanels; ++p) {
+        for (size_t i = 0; i < this->panelX[p].size(); ++i) {
+            x[p].push_back(DataView(this->panelX[p][i]));
+            y[p].push_back(DataView(this->panelY[p][i]));
+        }
+        this->panels[p]->dropUnplottable(x[p], y[p], plottableX[p], plottableY[p]);
+        if (this->panels[p]->decimation != gnuplot_decimation_type::GNUPLOT_NO_DECIMATION)
+            this->panels[p]->decimate(x[p], y[p], decimatedX[p], decimatedY[p]);
+
+        allX.insert(allX.end(), x[p].begin(), x[p].end());
+        allY.insert(allY.end(), y[p].begin(), y[p].end());
+    }
+    for (size_t i = 0; i < allX.size(); ++i) this->page.stats.pointsWritten += allX[i].size();
+
+    // data of all the panels goes in one source: panel after panel, series after series
+    const bool binary = this->page.binaryData();
+    const string source = this->page.writeData([&](ostream& out) {
+        if (binary) writeBinarySeries(out, allX, allY);
+        else writeTextSeries(out, allX, allY, this->page.dataPrecision);
+    });
+
+    string script;
+    if(this->page.action == gnuplot_action_type::GNUPLOT_SAVE) script += write_action_save();
+    script += this->page.dataBlock;
+    this->page.dataBlock.clear();
+
+    script += "set multiplot layout " + to_string(this->rows) + "," + to_string(this->cols);
+    if (!this->title.empty()) script += " title \"" + this->title + "\"";
+    script += '\n';
+
+    size_t block = 0;
+    size_t offset = 0;
+    bool empty = true;
+    for (size_t p = 0; p < nPanels; ++p) {
+        const GnuplotDriver& settings = *this->panels[p];
+
+        vector<string> titles;
+        const bool noLegend = settings.seriesTitles(x[p].size(), titles);
+        const string plotCommand = settings.seriesPlot(source, binary, x[p], titles, noLegend, block, offset);
+
+        if (plotCommand.empty()) {
+            script += "set multiplot next\n";
+            continue;
+        }
+
+        script += panelDefaults;
+        script += settings.axisSettings();
+        script += plotCommand;
+        script += '\n';
+        empty = false;
+    }
+
+    script += "unset multiplot\n";
+
+    if (empty) {
+        cout << "[WARNING] nothing to plot, all the panels are empty." << endl;
+        this->page.finishStats(0);
+        return 0;
+    }
+
+    // a session outlives the page: close the exported file and go back to the default terminal
+    if(this->page.session && this->page.action == gnuplot_action_type::GNUPLOT_SAVE) script += "unset output\nset term pop\n";
+
+    return this->page.executeGnuplot(script);
+
+}
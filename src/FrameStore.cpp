@@ -0,0 +1,169 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "FrameStore.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+
+FrameStore::FrameStore(const size_t &spillThreshold) {
+
+    this->nCurves = 0;
+    this->nPoints = 0;
+    this->nFrames = 0;
+    this->spillThreshold = spillThreshold;
+    this->fd = -1;
+    this->mapped = nullptr;
+    this->mappedFrames = 0;
+
+}
+
+FrameStore::~FrameStore() {
+
+    release();
+
+}
+
+void FrameStore::release() {
+
+    if (this->mapped) munmap(this->mapped, this->mappedFrames * this->nCurves * this->nPoints * sizeof(double));
+    if (this->fd >= 0) close(this->fd);
+
+    this->mapped = nullptr;
+    this->mappedFrames = 0;
+    this->fd = -1;
+
+}
+
+void FrameStore::clear() {
+
+    release();
+    this->memory = vector<double>();
+    this->nCurves = 0;
+    this->nPoints = 0;
+    this->nFrames = 0;
+
+}
+
+void FrameStore::setSpillThreshold(const size_t &bytes) {
+
+    this->spillThreshold = bytes;
+
+}
+
+void FrameStore::push(const vector<DataView> &y) {
+
+    if (this->nFrames == 0) {
+        this->nCurves = y.size();
+        this->nPoints = y.empty() ? 0 : y[0].size();
+    }
+
+    if (y.size() != this->nCurves) {
+        cout<<"\n\n[ERROR] every frame must have the same number of curves.\n\n"<<endl;
+        throw std::runtime_error("void FrameStore::push(const vector<DataView> &y)");
+    }
+    for (size_t k = 0; k < y.size(); ++k) {
+        if (y[k].size() != this->nPoints) {
+            cout<<"\n\n[ERROR] every curve of every frame must have the same dimension.\n\n"<<endl;
+            throw std::runtime_error("void FrameStore::push(const vector<DataView> &y)");
+        }
+    }
+
+    double* dst = reserveFrame();
+    for (size_t k = 0; k < y.size(); ++k) {
+        y[k].copyTo(dst + k * this->nPoints);
+    }
+    ++this->nFrames;
+
+}
+
+double *FrameStore::reserveFrame() {
+
+    const size_t frameSize = this->nCurves * this->nPoints;
+
+    if (!this->mapped && (this->nFrames + 1) * frameSize * sizeof(double) <= this->spillThreshold) {
+        this->memory.resize((this->nFrames + 1) * frameSize);
+        return this->memory.data() + this->nFrames * frameSize;
+    }
+
+    if (!this->mapped) spill();
+    if (this->nFrames + 1 > this->mappedFrames) grow(max(2 * this->mappedFrames, this->nFrames + 1));
+
+    return this->mapped + this->nFrames * frameSize;
+
+}
+
+void FrameStore::spill() {
+
+    const char* tmpDir = getenv("TMPDIR");
+    string name = string((tmpDir && *tmpDir) ? tmpDir : "/tmp") + "/simplePlot_frames_XXXXXX";
+
+    // close on exec: not inherited by gnuplot processes started by other threads
+    this->fd = mkostemp(&name[0], O_CLOEXEC);
+    if (this->fd < 0) {
+        cout<<"\n\n[ERROR] could not create file to store animation frames.\n\n"<<endl;
+        throw std::runtime_error("void FrameStore::spill()");
+    }
+    // the file lives as long as the descriptor, whatever happens to the process
+    unlink(name.c_str());
+
+    grow(max<size_t>(this->nFrames + 1, 16));
+
+    if (this->nFrames > 0) memcpy(this->mapped, this->memory.data(), this->nFrames * this->nCurves * this->nPoints * sizeof(double));
+    this->memory = vector<double>();
+
+}
+
+void FrameStore::grow(const size_t &frames) {
+
+    const size_t frameBytes = this->nCurves * this->nPoints * sizeof(double);
+
+    if (this->mapped) munmap(this->mapped, this->mappedFrames * frameBytes);
+    this->mapped = nullptr;
+
+    if (ftruncate(this->fd, frames * frameBytes) != 0) {
+        cout<<"\n\n[ERROR] could not grow file storing animation frames.\n\n"<<endl;
+        throw std::runtime_error("void FrameStore::grow(const size_t &frames)");
+    }
+
+    void* p = mmap(nullptr, max<size_t>(frames * frameBytes, 1), PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    if (p == MAP_FAILED) {
+        cout<<"\n\n[ERROR] could not map file storing animation frames.\n\n"<<endl;
+        throw std::runtime_error("void FrameStore::grow(const size_t &frames)");
+    }
+
+    this->mapped = static_cast<double*>(p);
+    this->mappedFrames = frames;
+
+}
+
+const double *FrameStore::frame(const size_t &f) const {
+
+    const size_t frameSize = this->nCurves * this->nPoints;
+    return (this->mapped ? this->mapped : this->memory.data()) + f * frameSize;
+
+}
+
+void FrameStore::adviseSequential() const {
+
+    if (this->mapped) madvise(this->mapped, this->mappedFrames * this->nCurves * this->nPoints * sizeof(double), MADV_SEQUENTIAL);
+
+}
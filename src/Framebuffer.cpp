@@ -0,0 +1,217 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "Framebuffer.h"
+#include "PngEncoder.h"
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+// 5x7 font, characters 32 to 126: 7 rows from the top, bit 4 is the leftmost pixel
+static const unsigned char font5x7[95][7] = {
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00}, {0x04,0x04,0x04,0x04,0x04,0x00,0x04}, // space !
+    {0x0A,0x0A,0x0A,0x00,0x00,0x00,0x00}, {0x0A,0x0A,0x1F,0x0A,0x1F,0x0A,0x0A}, // " #
+    {0x04,0x0F,0x14,0x0E,0x05,0x1E,0x04}, {0x18,0x19,0x02,0x04,0x08,0x13,0x03}, // $ %
+    {0x0C,0x12,0x14,0x08,0x15,0x12,0x0D}, {0x0C,0x04,0x08,0x00,0x00,0x00,0x00}, // & '
+    {0x02,0x04,0x08,0x08,0x08,0x04,0x02}, {0x08,0x04,0x02,0x02,0x02,0x04,0x08}, // ( )
+    {0x00,0x04,0x15,0x0E,0x15,0x04,0x00}, {0x00,0x04,0x04,0x1F,0x04,0x04,0x00}, // * +
+    {0x00,0x00,0x00,0x00,0x0C,0x04,0x08}, {0x00,0x00,0x00,0x1F,0x00,0x00,0x00}, // , -
+    {0x00,0x00,0x00,0x00,0x00,0x0C,0x0C}, {0x00,0x01,0x02,0x04,0x08,0x10,0x00}, // . /
+    {0x0E,0x11,0x13,0x15,0x19,0x11,0x0E}, {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}, // 0 1
+    {0x0E,0x11,0x01,0x02,0x04,0x08,0x1F}, {0x1F,0x02,0x04,0x02,0x01,0x11,0x0E}, // 2 3
+    {0x02,0x06,0x0A,0x12,0x1F,0x02,0x02}, {0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E}, // 4 5
+    {0x06,0x08,0x10,0x1E,0x11,0x11,0x0E}, {0x1F,0x01,0x02,0x04,0x08,0x08,0x08}, // 6 7
+    {0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E}, {0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C}, // 8 9
+    {0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x00}, {0x00,0x0C,0x0C,0x00,0x0C,0x04,0x08}, // : ;
+    {0x02,0x04,0x08,0x10,0x08,0x04,0x02}, {0x00,0x00,0x1F,0x00,0x1F,0x00,0x00}, // < =
+    {0x08,0x04,0x02,0x01,0x02,0x04,0x08}, {0x0E,0x11,0x01,0x02,0x04,0x00,0x04}, // > ?
+    {0x0E,0x11,0x01,0x0D,0x15,0x15,0x0E}, {0x0E,0x11,0x11,0x11,0x1F,0x11,0x11}, // @ A
+    {0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E}, {0x0E,0x11,0x10,0x10,0x10,0x11,0x0E}, // B C
+    {0x1C,0x12,0x11,0x11,0x11,0x12,0x1C}, {0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F}, // D E
+    {0x1F,0x10,0x10,0x1E,0x10,0x10,0x10}, {0x0E,0x11,0x10,0x17,0x11,0x11,0x0F}, // F G
+    {0x11,0x11,0x11,0x1F,0x11,0x11,0x11}, {0x0E,0x04,0x04,0x04,0x04,0x04,0x0E}, // H I
+    {0x07,0x02,0x02,0x02,0x02,0x12,0x0C}, {0x11,0x12,0x14,0x18,0x14,0x12,0x11}, // J K
+    {0x10,0x10,0x10,0x10,0x10,0x10,0x1F}, {0x11,0x1B,0x15,0x15,0x11,0x11,0x11}, // L M
+    {0x11,0x11,0x19,0x15,0x13,0x11,0x11}, {0x0E,0x11,0x11,0x11,0x11,0x11,0x0E}, // N O
+    {0x1E,0x11,0x11,0x1E,0x10,0x10,0x10}, {0x0E,0x11,0x11,0x11,0x15,0x12,0x0D}, // P Q
+    {0x1E,0x11,0x11,0x1E,0x14,0x12,0x11}, {0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E}, // R S
+    {0x1F,0x04,0x04,0x04,0x04,0x04,0x04}, {0x11,0x11,0x11,0x11,0x11,0x11,0x0E}, // T U
+    {0x11,0x11,0x11,0x11,0x11,0x0A,0x04}, {0x11,0x11,0x11,0x15,0x15,0x15,0x0A}, // V W
+    {0x11,0x11,0x0A,0x04,0x0A,0x11,0x11}, {0x11,0x11,0x11,0x0A,0x04,0x04,0x04}, // X Y
+    {0x1F,0x01,0x02,0x04,0x08,0x10,0x1F}, {0x0E,0x08,0x08,0x08,0x08,0x08,0x0E}, // Z [
+    {0x00,0x10,0x08,0x04,0x02,0x01,0x00}, {0x0E,0x02,0x02,0x02,0x02,0x02,0x0E}, // backslash ]
+    {0x04,0x0A,0x11,0x00,0x00,0x00,0x00}, {0x00,0x00,0x00,0x00,0x00,0x00,0x1F}, // ^ _
+    {0x08,0x04,0x02,0x00,0x00,0x00,0x00}, {0x00,0x00,0x0E,0x01,0x0F,0x11,0x0F}, // ` a
+    {0x10,0x10,0x16,0x19,0x11,0x11,0x1E}, {0x00,0x00,0x0E,0x10,0x10,0x11,0x0E}, // b c
+    {0x01,0x01,0x0D,0x13,0x11,0x11,0x0F}, {0x00,0x00,0x0E,0x11,0x1F,0x10,0x0E}, // d e
+    {0x06,0x09,0x08,0x1C,0x08,0x08,0x08}, {0x00,0x0F,0x11,0x11,0x0F,0x01,0x0E}, // f g
+    {0x10,0x10,0x16,0x19,0x11,0x11,0x11}, {0x04,0x00,0x0C,0x04,0x04,0x04,0x0E}, // h i
+    {0x02,0x00,0x06,0x02,0x02,0x12,0x0C}, {0x10,0x10,0x12,0x14,0x18,0x14,0x12}, // j k
+    {0x0C,0x04,0x04,0x04,0x04,0x04,0x0E}, {0x00,0x00,0x1A,0x15,0x15,0x11,0x11}, // l m
+    {0x00,0x00,0x16,0x19,0x11,0x11,0x11}, {0x00,0x00,0x0E,0x11,0x11,0x11,0x0E}, // n o
+    {0x00,0x00,0x1E,0x11,0x1E,0x10,0x10}, {0x00,0x00,0x0D,0x13,0x0F,0x01,0x01}, // p q
+    {0x00,0x00,0x16,0x19,0x10,0x10,0x10}, {0x00,0x00,0x0E,0x10,0x0E,0x01,0x1E}, // r s
+    {0x08,0x08,0x1C,0x08,0x08,0x09,0x06}, {0x00,0x00,0x11,0x11,0x11,0x13,0x0D}, // t u
+    {0x00,0x00,0x11,0x11,0x11,0x0A,0x04}, {0x00,0x00,0x11,0x11,0x15,0x15,0x0A}, // v w
+    {0x00,0x00,0x11,0x0A,0x04,0x0A,0x11}, {0x00,0x00,0x11,0x11,0x0F,0x01,0x0E}, // x y
+    {0x00,0x00,0x1F,0x02,0x04,0x08,0x1F}, {0x02,0x04,0x04,0x08,0x04,0x04,0x02}, // z {
+    {0x04,0x04,0x04,0x04,0x04,0x04,0x04}, {0x08,0x04,0x04,0x02,0x04,0x04,0x08}, // | }
+    {0x00,0x00,0x08,0x15,0x02,0x00,0x00}                                        // ~
+};
+
+Framebuffer::Framebuffer(const size_t &width, const size_t &height, const uint32_t &background) {
+
+    this->w = width;
+    this->h = height;
+    this->pixels.resize(4 * width * height);
+    setClip(0, 0, (int) width - 1, (int) height - 1);
+
+    fillRect(0, 0, (int) width - 1, (int) height - 1, background);
+
+}
+
+void Framebuffer::setClip(const int &x0, const int &y0, const int &x1, const int &y1) {
+
+    this->clipX0 = std::max(0, x0);
+    this->clipY0 = std::max(0, y0);
+    this->clipX1 = std::min((int) this->w - 1, x1);
+    this->clipY1 = std::min((int) this->h - 1, y1);
+
+}
+
+void Framebuffer::fillRect(const int &x0, const int &y0, const int &x1, const int &y1, const uint32_t &color) {
+
+    const int left = std::max(0, x0), right = std::min((int) this->w - 1, x1);
+    const int top = std::max(0, y0), bottom = std::min((int) this->h - 1, y1);
+    if (left > right || top > bottom) return;
+
+    // first row pixel by pixel, the others copied from it
+    unsigned char* first = this->pixels.data() + 4 * (top * this->w + left);
+    unsigned char* p = first;
+    for (int x = left; x <= right; ++x, p += 4) {
+        p[0] = (unsigned char) (color >> 16);
+        p[1] = (unsigned char) (color >> 8);
+        p[2] = (unsigned char) color;
+        p[3] = 255;
+    }
+    const size_t bytes = 4 * (right - left + 1);
+    for (int y = top + 1; y <= bottom; ++y) memcpy(first + 4 * (y - top) * this->w, first, bytes);
+
+}
+
+void Framebuffer::blend(const int &x, const int &y, const uint32_t &color, const double &coverage) {
+
+    if (x < this->clipX0 || x > this->clipX1 || y < this->clipY0 || y > this->clipY1 || coverage <= 0) return;
+
+    unsigned char* p = this->pixels.data() + 4 * (y * this->w + x);
+    const int a = (int) (coverage * 256);
+    const int c[3] = {(int) ((color >> 16) & 0xFF), (int) ((color >> 8) & 0xFF), (int) (color & 0xFF)};
+    for (int k = 0; k < 3; ++k) p[k] = (unsigned char) (p[k] + (((c[k] - p[k]) * std::min(a, 256)) >> 8));
+
+}
+
+void Framebuffer::drawLine(double x0, double y0, double x1, double y1, const uint32_t &color) {
+
+    // Liang-Barsky clipping to the clip rectangle (half a pixel around it is still partly covered)
+    const double bounds[4] = {this->clipX0 - 0.5, this->clipX1 + 0.5, this->clipY0 - 0.5, this->clipY1 + 0.5};
+    const double dx = x1 - x0, dy = y1 - y0;
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {x0 - bounds[0], bounds[1] - x0, y0 - bounds[2], bounds[3] - y0};
+    double t0 = 0, t1 = 1;
+    for (int k = 0; k < 4; ++k) {
+        if (p[k] == 0) {
+            if (q[k] < 0) return;
+            continue;
+        }
+        const double t = q[k] / p[k];
+        if (p[k] < 0) t0 = std::max(t0, t);
+        else t1 = std::min(t1, t);
+    }
+    if (t0 > t1 || !(t0 == t0)) return;
+    x1 = x0 + t1 * dx;
+    y1 = y0 + t1 * dy;
+    x0 = x0 + t0 * dx;
+    y0 = y0 + t0 * dy;
+
+    // Xiaolin Wu: the two pixels across the line share its coverage
+    const bool steep = fabs(y1 - y0) > fabs(x1 - x0);
+    if (steep) {
+        swap(x0, y0);
+        swap(x1, y1);
+    }
+    if (x0 > x1) {
+        swap(x0, x1);
+        swap(y0, y1);
+    }
+    const double gradient = (x1 > x0) ? (y1 - y0) / (x1 - x0) : 0;
+
+    auto plot = [&](const int& a, const int& b, const double& coverage) {
+        if (steep) blend(b, a, color, coverage);
+        else blend(a, b, color, coverage);
+    };
+
+    const int first = (int) floor(x0 + 0.5);
+    const int last = (int) floor(x1 + 0.5);
+    for (int a = first; a <= last; ++a) {
+        // coverage along the line: partial at the two ends
+        double along = 1;
+        if (first == last) along = x1 - x0 + (x0 == x1 ? 1 : 0);
+        else if (a == first) along = first + 0.5 - x0;
+        else if (a == last) along = x1 - (last - 0.5);
+
+        const double y = y0 + gradient * (a - x0);
+        const int b = (int) floor(y);
+        const double f = y - b;
+        plot(a, b, (1 - f) * along);
+        plot(a, b + 1, f * along);
+    }
+
+}
+
+int Framebuffer::textWidth(const string &text, const int &scale) {
+
+    return text.empty() ? 0 : (int) (6 * text.size() - 1) * scale;
+
+}
+
+int Framebuffer::textHeight(const int &scale) {
+
+    return 7 * scale;
+
+}
+
+void Framebuffer::drawText(const int &x, const int &y, const string &text, const uint32_t &color, const int &scale, const bool &vertical) {
+
+    for (size_t c = 0; c < text.size(); ++c) {
+        const unsigned char ch = text[c];
+        const unsigned char* glyph = font5x7[(ch >= 32 && ch <= 126) ? ch - 32 : '?' - 32];
+        for (int row = 0; row < 7; ++row) {
+            for (int col = 0; col < 5; ++col) {
+                if (!(glyph[row] & (0x10 >> col))) continue;
+                const int along = (int) (6 * c + col) * scale;
+                const int across = row * scale;
+                if (vertical) fillRect(x + across, y - along - scale + 1, x + across + scale - 1, y - along, color);
+                else fillRect(x + along, y + across, x + along + scale - 1, y + across + scale - 1, color);
+            }
+        }
+    }
+
+}
+
+bool Framebuffer::savePng(const string &fileName) const {
+
+    return writePng(fileName, this->pixels.data(), this->w, this->h);
+
+}
@@ -0,0 +1,139 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "GifStitch.h"
+#include <fstream>
+#include <iterator>
+
+// parsed GIF file: everything between the global color table and the trailer is kept as blocks
+struct GifFile {
+    string data;
+    size_t screenEnd;       // end of header, logical screen descriptor and global color table
+    string colorTable;      // global color table, empty if none
+    unsigned char tableBits;
+    vector<pair<size_t, size_t>> blocks; // [begin, end) of every extension or image
+};
+
+// skips data sub-blocks starting at pos, returns the position after the terminator or npos
+static size_t skipSubBlocks(const string& d, size_t pos) {
+
+    while (pos < d.size()) {
+        const unsigned char n = d[pos];
+        pos += 1 + n;
+        if (n == 0) return pos;
+    }
+    return string::npos;
+
+}
+
+static bool readGif(const string& fileName, GifFile& gif) {
+
+    ifstream in(fileName, ios::binary);
+    if (!in) return false;
+    gif.data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+
+    const string& d = gif.data;
+    if (d.size() < 13 || d.compare(0, 3, "GIF") != 0) return false;
+
+    const unsigned char packed = d[10];
+    size_t pos = 13;
+    gif.tableBits = packed & 0x07;
+    if (packed & 0x80) {
+        const size_t tableSize = 3u << (gif.tableBits + 1);
+        if (pos + tableSize > d.size()) return false;
+        gif.colorTable = d.substr(pos, tableSize);
+        pos += tableSize;
+    }
+    gif.screenEnd = pos;
+
+    while (pos < d.size()) {
+        const unsigned char type = d[pos];
+        const size_t begin = pos;
+
+        if (type == 0x3B) {
+            return true;
+        } else if (type == 0x21) {
+            if (pos + 2 > d.size()) return false;
+            pos = skipSubBlocks(d, pos + 2);
+        } else if (type == 0x2C) {
+            if (pos + 10 > d.size()) return false;
+            const unsigned char imagePacked = d[pos + 9];
+            pos += 10;
+            if (imagePacked & 0x80) pos += 3u << ((imagePacked & 0x07) + 1);
+            pos = skipSubBlocks(d, pos + 1); // after the LZW minimum code size
+        } else {
+            return false;
+        }
+
+        if (pos == string::npos || pos > d.size()) return false;
+        gif.blocks.push_back(make_pair(begin, pos));
+    }
+
+    // missing trailer: keep what has been read
+    return true;
+
+}
+
+static bool isLoopExtension(const string& d, const pair<size_t, size_t>& block) {
+
+    return d[block.first] == 0x21 && (unsigned char) d[block.first + 1] == 0xFF;
+
+}
+
+bool stitchGifs(const vector<string> &parts, const string &fileName) {
+
+    if (parts.empty()) return false;
+
+    GifFile first;
+    if (!readGif(parts[0], first)) return false;
+
+    ofstream out(fileName, ios::binary | ios::trunc);
+    if (!out) return false;
+
+    out.write(first.data.data(), first.screenEnd);
+
+    for (size_t p = 0; p < parts.size(); ++p) {
+        GifFile part;
+        if (p == 0) part = first;
+        else if (!readGif(parts[p], part)) return false;
+
+        const string& d = part.data;
+        const bool ownTable = !part.colorTable.empty() &&
+                              (part.colorTable != first.colorTable || part.tableBits != first.tableBits);
+
+        for (size_t b = 0; b < part.blocks.size(); ++b) {
+            const pair<size_t, size_t>& block = part.blocks[b];
+
+            // loop settings only once, from the first part
+            if (p > 0 && isLoopExtension(d, block)) continue;
+
+            if (ownTable && d[block.first] == 0x2C && !((unsigned char) d[block.first + 9] & 0x80)) {
+                // image using the global color table of its part: the table becomes local
+                string descriptor = d.substr(block.first, 10);
+                descriptor[9] = (char) (((unsigned char) descriptor[9] & 0x78) | 0x80 | part.tableBits);
+                out.write(descriptor.data(), descriptor.size());
+                out.write(part.colorTable.data(), part.colorTable.size());
+                out.write(d.data() + block.first + 10, block.second - block.first - 10);
+            } else {
+                out.write(d.data() + block.first, block.second - block.first);
+            }
+        }
+    }
+
+    out.put((char) 0x3B);
+
+    return (bool) out;
+
+}
@@ -0,0 +1,322 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "GnuplotData.h"
+#include "NumberFormat.h"
+#include <cstring>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <cerrno>
+#include <unistd.h>
+
+bool hostIsLittleEndian() {
+
+    const uint16_t one = 1;
+    unsigned char first;
+    memcpy(&first, &one, 1);
+    return first == 1;
+
+}
+
+FdStreamBuffer::FdStreamBuffer(int fd) {
+
+    this->fd = fd;
+    setp(this->buffer, this->buffer + sizeof(this->buffer));
+
+}
+
+FdStreamBuffer::~FdStreamBuffer() {
+
+    flushBuffer();
+
+}
+
+bool FdStreamBuffer::flushBuffer() {
+
+    const char* p = pbase();
+    size_t n = pptr() - pbase();
+
+    while (n > 0) {
+        ssize_t w = write(this->fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += w;
+        n -= w;
+    }
+    setp(this->buffer, this->buffer + sizeof(this->buffer));
+    return true;
+
+}
+
+FdStreamBuffer::int_type FdStreamBuffer::overflow(int_type c) {
+
+    if (!flushBuffer()) return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+
+}
+
+int FdStreamBuffer::sync() {
+
+    return flushBuffer() ? 0 : -1;
+
+}
+
+void writeTextData(ostream &out, const vector<DataView> &columns, const int &precision) {
+
+    if (columns.empty()) return;
+
+    const size_t nRows = columns[0].size();
+    const size_t nColumns = columns.size();
+
+    TextWriter writer(out, precision);
+
+    for (size_t i = 0; i < nRows; ++i) {
+        writer.put(columns[0][i]);
+        for (size_t j = 1; j < nColumns; ++j) {
+            writer.put(' ');
+            writer.put(columns[j][i]);
+        }
+        writer.put('\n');
+    }
+
+}
+
+void writeBinaryData(ostream &out, const vector<DataView> &columns) {
+
+    if (columns.empty()) return;
+
+    const size_t nRows = columns[0].size();
+    const size_t nColumns = columns.size();
+
+    BinaryWriter writer(out);
+
+    for (size_t i = 0; i < nRows; ++i) {
+        writer.reserve(nColumns);
+        for (size_t j = 0; j < nColumns; ++j) {
+            writer.put(columns[j][i]);
+        }
+    }
+
+}
+
+void writeTextSeries(ostream &out, const vector<DataView> &x, const vector<DataView> &y, const int &precision) {
+
+    TextWriter writer(out, precision);
+    bool first = true;
+
+    // values of views that are not contiguous doubles are converted here, a chunk at a time
+    double bufferX[DataView::chunkSize], bufferY[DataView::chunkSize];
+
+    for (size_t s = 0; s < x.size(); ++s) {
+        const size_t n = x[s].size();
+        if (n == 0) continue;
+
+        if (!first) {
+            writer.put('\n');
+            writer.put('\n');
+        }
+        first = false;
+
+        for (size_t start = 0; start < n; start += DataView::chunkSize) {
+            const size_t count = min(DataView::chunkSize, n - start);
+            const double* xs = x[s].read(start, count, bufferX);
+            const double* ys = y[s].read(start, count, bufferY);
+            for (size_t i = 0; i < count; ++i) {
+                writer.put(xs[i]);
+                writer.put(' ');
+                writer.put(ys[i]);
+                writer.put('\n');
+            }
+        }
+    }
+
+}
+
+void writeBinarySeries(ostream &out, const vector<DataView> &x, const vector<DataView> &y) {
+
+    BinaryWriter writer(out);
+    double bufferX[DataView::chunkSize], bufferY[DataView::chunkSize];
+
+    for (size_t s = 0; s < x.size(); ++s) {
+        const size_t n = x[s].size();
+
+        for (size_t start = 0; start < n; start += DataView::chunkSize) {
+            const size_t count = min(DataView::chunkSize, n - start);
+            const double* xs = x[s].read(start, count, bufferX);
+            const double* ys = y[s].read(start, count, bufferY);
+            for (size_t i = 0; i < count; ++i) {
+                writer.reserve(2);
+                writer.put(xs[i]);
+                writer.put(ys[i]);
+            }
+        }
+    }
+
+}
+
+void writeTextFrames(ostream &out, const DataView &x, const FrameStore &frames, ValueRange &yRange, const bool &logY,
+                     const int &precision) {
+
+    const size_t nPoints = frames.points();
+    const size_t nCurves = frames.curves();
+
+    TextWriter writer(out, precision);
+
+    for (size_t f = 0; f < frames.frames(); ++f) {
+        const double* y = frames.frame(f);
+        // the frame is contiguous: one pass over every curve, just before it is written
+        yRange.merge(valueRange(y, nCurves * nPoints, logY));
+        if (f > 0) {
+            writer.put('\n');
+            writer.put('\n');
+        }
+
+        for (size_t i = 0; i < nPoints; ++i) {
+            writer.put(x[i]);
+            for (size_t k = 0; k < nCurves; ++k) {
+                writer.put(' ');
+                writer.put(y[k * nPoints + i]);
+            }
+            writer.put('\n');
+        }
+    }
+
+}
+
+void writeBinaryFrames(ostream &out, const DataView &x, const FrameStore &frames, ValueRange &yRange, const bool &logY) {
+
+    const size_t nPoints = frames.points();
+    const size_t nCurves = frames.curves();
+
+    BinaryWriter writer(out);
+
+    for (size_t f = 0; f < frames.frames(); ++f) {
+        const double* y = frames.frame(f);
+        // the frame is contiguous: one pass over every curve, just before it is written
+        yRange.merge(valueRange(y, nCurves * nPoints, logY));
+
+        for (size_t i = 0; i < nPoints; ++i) {
+            writer.reserve(nCurves + 1);
+            writer.put(x[i]);
+            for (size_t k = 0; k < nCurves; ++k) {
+                writer.put(y[k * nPoints + i]);
+            }
+        }
+    }
+
+}
+
+string binaryDataSpec(const size_t &nRows, const size_t &nColumns) {
+
+    string format;
+    for (size_t j = 0; j < nColumns; ++j) format += "%double";
+
+    return " binary record=(" + to_string(nRows) + ") format=\"" + format + "\" endian=little";
+
+}
+
+string binarySeriesSpec(const size_t &nRows, const size_t &offset) {
+
+    return " binary record=(" + to_string(nRows) + ") skip=" + to_string(offset) + " format=\"%double%double\" endian=little";
+
+}
+
+// value written for a bin: nan for empty bins on a log color scale
+static inline double binValue(const uint64_t& count, const bool& logCounts) {
+
+    return (logCounts && count == 0) ? numeric_limits<double>::quiet_NaN() : (double) count;
+
+}
+
+void writeTextImage(ostream &out, const Histogram2D &histogram, const bool &logCounts, const int &precision) {
+
+    TextWriter writer(out, precision);
+
+    vector<double> xCenters(histogram.xBins());
+    for (size_t i = 0; i < histogram.xBins(); ++i) xCenters[i] = histogram.xCenter(i);
+
+    for (size_t j = 0; j < histogram.yBins(); ++j) {
+        const double y = histogram.yCenter(j);
+        for (size_t i = 0; i < histogram.xBins(); ++i) {
+            writer.put(xCenters[i]);
+            writer.put(' ');
+            writer.put(y);
+            writer.put(' ');
+            writer.put(binValue(histogram.count(i, j), logCounts));
+            writer.put('\n');
+        }
+        writer.put('\n');
+    }
+
+}
+
+void writeBinaryImage(ostream &out, const Histogram2D &histogram, const bool &logCounts) {
+
+    BinaryWriter writer(out);
+
+    for (size_t j = 0; j < histogram.yBins(); ++j) {
+        for (size_t i = 0; i < histogram.xBins(); ++i) {
+            writer.reserve(1);
+            writer.put(binValue(histogram.count(i, j), logCounts));
+        }
+    }
+
+}
+
+string binaryImageSpec(const Histogram2D &histogram) {
+
+    const double dx = (histogram.xEdge(histogram.xBins()) - histogram.xEdge(0)) / histogram.xBins();
+    const double dy = (histogram.yEdge(histogram.yBins()) - histogram.yEdge(0)) / histogram.yBins();
+
+    return " binary array=(" + to_string(histogram.xBins()) + "," + to_string(histogram.yBins()) + ")" +
+           " dx=" + formatNumber(dx) + " dy=" + formatNumber(dy) +
+           " origin=(" + formatNumber(histogram.xCenter(0)) + "," + formatNumber(histogram.yCenter(0)) + ")" +
+           " format=\"%double\" endian=little";
+
+}
+
+void writeTextGrid(ostream &out, const Histogram2D &histogram, const bool &logCounts, const int &precision) {
+
+    TextWriter writer(out, precision);
+
+    const size_t nx = histogram.xBins();
+    const size_t ny = histogram.yBins();
+
+    vector<double> xEdges(nx + 1);
+    for (size_t i = 0; i <= nx; ++i) xEdges[i] = histogram.xEdge(i);
+
+    for (size_t j = 0; j <= ny; ++j) {
+        const double y = histogram.yEdge(j);
+        for (size_t i = 0; i <= nx; ++i) {
+            writer.put(xEdges[i]);
+            writer.put(' ');
+            writer.put(y);
+            writer.put(' ');
+            writer.put((i < nx && j < ny) ? binValue(histogram.count(i, j), logCounts) : 0.0);
+            writer.put('\n');
+        }
+        writer.put('\n');
+    }
+
+}
@@ -15,84 +15,156 @@
 
 #include "GnuplotDriver.h"
 #include <iostream>
+#include <stdexcept>
+#include <cerrno>
+#include <sstream>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include "GifStitch.h"
+#include "NumberFormat.h"
 #include <execinfo.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
-vector<vector<vector<double>>> GnuplotDriver::videoData = {};
+// adds the time from construction to destruction to seconds, if on. When off the clock is not read
+class PhaseTimer {
 
-GnuplotDriver::GnuplotDriver(gnuplot_axis_type axis, gnuplot_action_type action_type, string fileName, gnuplot_save_type format) {
+private:
 
-    this->id = rand();
-    this->commandFileName = "/tmp/gnuplotFile" + to_string(this->id) + ".txt";
-    this->dataFileName = "/tmp/tmp_gnuplot_data" + to_string(this->id) + ".txt";
+    double& seconds;
+    bool on;
+    chrono::steady_clock::time_point start;
 
-    this->action = action_type;
+public:
+    PhaseTimer(double& seconds, const bool& on) : seconds(seconds), on(on) {
+        if (on) this->start = chrono::steady_clock::now();
+    }
+    ~PhaseTimer() {
+        if (this->on) this->seconds += chrono::duration<double>(chrono::steady_clock::now() - this->start).count();
+    }
+
+};
+
+GnuplotDriver::GnuplotDriver(gnuplot_axis_type axis, gnuplot_action_type action_type, string fileName, gnuplot_save_type format) {
 
-    this->commandFile.open(this->commandFileName,ios::trunc);
+    this->action = action_type;
 
     this->plotOptions = " w l";
+    this->saveWidth = 0;
+    this->saveHeight = 0;
+    this->titleFontSize = 0;
+    this->xLabelFontSize = 0;
+    this->yLabelFontSize = 0;
+    this->yRangeSet = false;
+    this->yRangeMin = 0;
+    this->yRangeMax = 0;
+    this->dataFormat = gnuplot_data_format::GNUPLOT_TEXT;
+    this->dataTransport = gnuplot_data_transport::GNUPLOT_FILE;
+    this->dataPrecision = 0;
+    this->dataFd = -1;
+    this->decimation = gnuplot_decimation_type::GNUPLOT_NO_DECIMATION;
+    this->decimationPixels = 640;
+    this->xRangeSet = false;
+    this->streamCapacity = 0;
+    this->streamPeriod = 0;
+    this->xRangeMin = 0;
+    this->xRangeMax = 0;
+    this->statsOn = false;
+    this->dataHashed = false;
 
     if (fileName == "plot.png" && format == gnuplot_save_type::GNUPLOT_EPS) fileName = "plot.eps";
 
     this->saveName = fileName;
     this->saveType = format;
 
-    if(this->action == gnuplot_action_type::GNUPLOT_SAVE) write_action_save();
-
     this->axisType = axis;
-    switch (axisType) {
-    case gnuplot_axis_type::GNUPLOT_XLOG:
-      write_command("set logscale x");
-      break;
-    case gnuplot_axis_type::GNUPLOT_YLOG:
-      write_command("set logscale y");
-      break;
-    case gnuplot_axis_type::GNUPLOT_LOGLOG:
-      write_command("set logscale xy");
-      break;
-    }
 }
 
 GnuplotDriver::~GnuplotDriver() {
 
-//    this->commandFile.close();
+    if (this->dataFd >= 0) close(this->dataFd);
+
+    // removes temporary files, if any was written
+    if (!this->sessionDir.empty()) {
+        unlink(this->commandFileName.c_str());
+        unlink(this->dataFileName.c_str());
+        rmdir(this->sessionDir.c_str());
+    }
+
+}
+
+void GnuplotDriver::makeSessionDir() {
+
+    if (!this->sessionDir.empty()) return;
+
+    // mkdtemp picks a name no other driver, thread or process is using
+    const char* tmpDir = getenv("TMPDIR");
+    string dir = string((tmpDir && *tmpDir) ? tmpDir : "/tmp") + "/simplePlot_XXXXXX";
+    if (!mkdtemp(&dir[0])) {
+        cout<<"\n\n[ERROR] could not create directory for gnuplot files.\n\n"<<endl;
+        throw std::runtime_error("void GnuplotDriver::makeSessionDir()");
+    }
+
+    this->sessionDir = dir;
+    this->commandFileName = dir + "/commands.gp";
+    this->dataFileName = dir + "/data.txt";
 
 }
 
 void GnuplotDriver::write_command(const string& command) {
 
-    this->commandFile << command << endl;
+    this->commands += command;
+    this->commands += '\n';
 }
 
 void GnuplotDriver::setTitle(const string &title) {
 
+    this->titleText = title;
     write_command("set title \"" + title + "\"");
 
 }
 
 void GnuplotDriver::setXLabel(const string &str, const int& fontSize) {
 
+    this->xLabelText = str;
+    this->xLabelFontSize = fontSize;
     write_command("set xlabel \"" + str + "\" font \"," + to_string(fontSize) + "\"");
 
 }
 
 void GnuplotDriver::setYLabel(const string &str, const int& fontSize) {
 
+    this->yLabelText = str;
+    this->yLabelFontSize = fontSize;
     write_command("set ylabel \"" + str + "\" font \"," + to_string(fontSize) + "\"");
 
 }
 
 void GnuplotDriver::setXRange(const double &x0, const double &x1) {
 
-    write_command("set xrange [" + to_string(x0) + ":" + to_string(x1) + "]");
+    this->xRangeSet = true;
+    this->xRangeMin = min(x0, x1);
+    this->xRangeMax = max(x0, x1);
+
+    write_command("set xrange [" + formatNumber(x0) + ":" + formatNumber(x1) + "]");
 
 }
 
 void GnuplotDriver::setYRange(const double &y0, const double &y1) {
 
-    write_command("set yrange [" + to_string(y0) + ":" + to_string(y1) + "]");
+    this->yRangeSet = true;
+    this->yRangeMin = min(y0, y1);
+    this->yRangeMax = max(y0, y1);
+
+    write_command("set yrange [" + formatNumber(y0) + ":" + formatNumber(y1) + "]");
 
 }
 
@@ -104,266 +176,877 @@ void GnuplotDriver::setPlotOptions(const string &opts) {
 
 void GnuplotDriver::setTitleFont(const int &size) {
 
+    this->titleFontSize = size;
     write_command("set title  font \"," + to_string(size) + "\"");
 
 }
 
-string GnuplotDriver::getTitle(const string& str){
+string GnuplotDriver::getTitle(const string& str) const {
 
     return " title \"" + str + "\"";
 
 }
 
-void GnuplotDriver::plot(const vector<double> &x, const vector<double> &y) {
+bool GnuplotDriver::binaryData() const {
 
-    if(this->action == gnuplot_action_type::GNUPLOT_NONE){
-        cout << "[WARNING] gnuplot action is set to GNUPLOT_NONE." << endl;
-        return;
-    }
+    // datablocks can only hold text, dataFormat is ignored
+    return this->dataFormat == gnuplot_data_format::GNUPLOT_BINARY &&
+           this->dataTransport != gnuplot_data_transport::GNUPLOT_DATABLOCK;
 
-    if(x.size() != y.size()){
-        cout<<"\n\n[ERROR] x and y must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double> &x, const vector<double> &y)");
-    }
+}
 
-    bool noLegend = false;
-    if (this->legendTitles.empty()) {
-        legendTitles = vector<string>(1);
-        noLegend = true;
+string GnuplotDriver::writeData(const function<void(ostream&)> &write) {
+
+    this->dataSource = writeDataTo(this->renderCache ? [&](ostream& out) {
+        // data is hashed while it is written, for the render cache
+        this->dataHasher.reset();
+        HashingStreamBuffer hashing(out.rdbuf(), this->dataHasher);
+        ostream hashed(&hashing);
+        write(hashed);
+        this->dataHashed = true;
+    } : write);
+
+    return this->dataSource;
+
+}
+
+string GnuplotDriver::writeDataTo(const function<void(ostream&)> &write) {
+
+    PhaseTimer timer(this->stats.serializeSeconds, this->statsOn);
+
+    if (this->server && this->dataTransport != gnuplot_data_transport::GNUPLOT_DATABLOCK) {
+        // written by the server where its gnuplot can read it
+        ostringstream data(binaryData() ? (ios::out | ios::binary) : ios::out);
+        write(data);
+        this->serverData = data.str();
+        this->stats.dataBytes += this->serverData.size();
+        return serverDataSource;
     }
 
-    if(this->action != gnuplot_action_type::GNUPLOT_VIDEO) {
+    switch (this->dataTransport) {
+    case gnuplot_data_transport::GNUPLOT_DATABLOCK: {
+        ostringstream block;
+        block << "$SP_DATA << EOD\n";
+        write(block);
+        block << "EOD\n";
+        this->dataBlock = block.str();
+        this->stats.dataBytes += this->dataBlock.size();
+        return "$SP_DATA";
+    }
+    case gnuplot_data_transport::GNUPLOT_MEMFD: {
+#ifdef MFD_CLOEXEC
+        if (this->dataFd >= 0) close(this->dataFd);
+        this->dataFd = memfd_create("simplePlot_data", MFD_CLOEXEC);
+        if (this->dataFd < 0) {
+            cout<<"\n\n[ERROR] could not create memory file for gnuplot data.\n\n"<<endl;
+            throw std::runtime_error("string GnuplotDriver::writeDataTo(const function<void(ostream&)> &write)");
+        }
+        {
+            FdStreamBuffer buffer(this->dataFd);
+            ostream tmp(&buffer);
+            write(tmp);
+        }
+        if (this->statsOn) this->stats.dataBytes += lseek(this->dataFd, 0, SEEK_CUR);
+        // gnuplot (session or child) opens the memory file through our own descriptor table
+        return "\"/proc/" + to_string(getpid()) + "/fd/" + to_string(this->dataFd) + "\"";
+#else
+        // falls back to GNUPLOT_FILE
+        makeSessionDir();
+        cout << "[WARNING] memory files are not available, data is written in " << this->dataFileName << endl;
+#endif
+    }
+    default: {
         // creates (tmp) data file
+        makeSessionDir();
         ofstream tmp;
-        tmp.open(this->dataFileName, ios::trunc);
+        tmp.open(this->dataFileName, binaryData() ? (ios::trunc | ios::binary) : ios::trunc);
+        write(tmp);
+        if (this->statsOn) this->stats.dataBytes += tmp.tellp();
+        tmp.close();
+        return "\"" + this->dataFileName + "\"";
+    }
+    }
 
-        for (int i = 0; i < x.size(); ++i) {
-            tmp << x[i] << " " << y[i] << endl;
-        }
+}
 
-        tmp.close();
+void GnuplotDriver::plot(const vector<double> &x, const vector<double> &y) {
 
-        if (noLegend) write_command("set nokey"); // hides legend
-        write_command("plot \"" + this->dataFileName + "\"" + this->plotOptions + getTitle(this->legendTitles[0]));
+    plotSeries({DataView(x)}, {DataView(y)});
 
-        this->commandFile.close();
+}
+
+void GnuplotDriver::plot(const DataView &x, const DataView &y) {
+
+    plotSeries({x}, {y});
+
+}
+
+void GnuplotDriver::plot(const vector<vector<double>> &x, const vector<vector<double>> &y) {
+
+    plotSeries(vector<DataView>(x.begin(), x.end()), vector<DataView>(y.begin(), y.end()));
+
+}
+
+void GnuplotDriver::plot(const MinMaxPyramid &pyramid) {
+
+    if(this->action == gnuplot_action_type::GNUPLOT_VIDEO){
+        cout << "[WARNING] pyramids cannot be animation frames, use plot(x, y) in GNUPLOT_VIDEO mode." << endl;
+        return;
+    }
+
+    if(!pyramid.isSorted()){
+        cout << "[WARNING] x is not sorted, the series is plotted without the pyramid." << endl;
+        plotSeries({pyramid.xValues()}, {pyramid.yValues()});
+        return;
+    }
 
-        // execute gnuplot
-        executeGnuplot();
+    const bool logX = (this->axisType == gnuplot_axis_type::GNUPLOT_XLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+
+    // range of the x axis: the one set by the user or the one of the series
+    double xMin = this->xRangeMin;
+    double xMax = this->xRangeMax;
+    if (!this->xRangeSet) {
+        const ValueRange range = pyramid.xRange(logX);
+        xMin = range.min;
+        xMax = range.max;
     }
-    else{
-        if(this->videoData.empty()) this->videoData = vector<vector<vector<double>>>(1);
-        this->videoData[0].push_back(y);
+    if (xMin >= xMax) {
+        plotSeries({pyramid.xValues()}, {pyramid.yValues()});
+        return;
     }
 
+    vector<double> dx, dy;
+    {
+        PhaseTimer timer(this->stats.serializeSeconds, this->statsOn);
+        pyramid.decimate(xMin, xMax, logX, this->decimationPixels, dx, dy);
+    }
+
+    plotSeries({DataView(dx)}, {DataView(dy)});
+
 }
 
-void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0,
-                         const vector<double>& x1, const vector<double>& y1) {
+void GnuplotDriver::plotFile(const string &fileName, const FileLayout &layout, const size_t &xColumn, const vector<size_t> &yColumns,
+                             const function<double(double)> &xTransform, const function<double(double)> &yTransform) {
 
     if(this->action == gnuplot_action_type::GNUPLOT_NONE){
         cout << "[WARNING] gnuplot action is set to GNUPLOT_NONE." << endl;
         return;
     }
 
-    if(x0.size() != y0.size()){
-        cout<<"\n\n[ERROR] x0 and y0 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1)");
+    if(this->action == gnuplot_action_type::GNUPLOT_VIDEO){
+        cout << "[WARNING] files cannot be animation frames, plotFile is ignored in GNUPLOT_VIDEO mode." << endl;
+        return;
     }
-    if(x1.size() != y1.size()){
-        cout<<"\n\n[ERROR] x1 and y1 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1)");
+
+    if(yColumns.empty()){
+        cout<<"\n\n[ERROR] at least one y column must be plotted.\n\n"<<endl;
+        throw std::runtime_error("void GnuplotDriver::plotFile(const string &fileName, const FileLayout &layout, const size_t &xColumn, const vector<size_t> &yColumns, const function<double(double)> &xTransform, const function<double(double)> &yTransform)");
     }
 
-    bool noLegend = false;
-    if (this->legendTitles.empty()) {
-        legendTitles = vector<string>(2);
-        noLegend = true;
+    const DataFile file(fileName, layout);
+
+    vector<string> titles;
+    const bool noLegend = seriesTitles(yColumns.size(), titles);
+
+    vector<size_t> columns(1, xColumn);
+    columns.insert(columns.end(), yColumns.begin(), yColumns.end());
+
+    if(this->decimation != gnuplot_decimation_type::GNUPLOT_NO_DECIMATION) {
+        plotFileDecimated(file, columns, xTransform, yTransform, titles, noLegend);
+        return;
+    }
+    if(xTransform || yTransform) {
+        plotFileTransformed(file, columns, xTransform, yTransform, titles, noLegend);
+        return;
     }
 
-    if(this->action != gnuplot_action_type::GNUPLOT_VIDEO) {
-        // creates (tmp) data file
-        ofstream tmp;
-        tmp.open(this->dataFileName, ios::trunc);
+    // gnuplot reads the file as it is
+    const string source = "\"" + fileName + "\"" + file.gnuplotSpec();
+    string plotCommand;
+    for (size_t k = 0; k < yColumns.size(); ++k) {
+        plotCommand += (k == 0) ? "plot " : ", ";
+        plotCommand += source + " u " + to_string(xColumn + 1) + ":" + to_string(yColumns[k] + 1);
+        plotCommand += this->plotOptions + getTitle(titles[k]);
+    }
+    if (noLegend) plotCommand = "set nokey\n" + plotCommand;
 
-        for (int i = 0; i < x0.size(); ++i) {
-            tmp << x0[i] << " " << y0[i] << " " << x1[i] << " " << y1[i] << endl;
-        }
+    // the separator is a global setting: it is restored for the next plots of a session
+    const string separator = file.separatorCommand();
+    if (!separator.empty()) plotCommand = separator + "\n" + plotCommand + "\nset datafile separator whitespace";
 
-        tmp.close();
+    executeGnuplot(buildScript(plotCommand));
 
-        if (noLegend) write_command("set nokey"); // hides legend
-        write_command(
-                "plot \"" + this->dataFileName + "\" u 1:2" + this->plotOptions + getTitle(legendTitles[0]) + ", '' u 3:4" + this->plotOptions + getTitle(legendTitles[1]));
+}
+
+int GnuplotDriver::plotFileDecimated(const DataFile &file, const vector<size_t> &columns,
+                                     const function<double(double)> &xTransform, const function<double(double)> &yTransform,
+                                     const vector<string> &titles, const bool &noLegend) {
+
+    const bool logX = (this->axisType == gnuplot_axis_type::GNUPLOT_XLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+    const size_t nSeries = columns.size() - 1;
+
+    // range of the x axis: the one set by the user or the one gnuplot will compute from data
+    double xMin = this->xRangeMin;
+    double xMax = this->xRangeMax;
+    if (!this->xRangeSet) {
+        xMin = numeric_limits<double>::max();
+        xMax = -numeric_limits<double>::max();
+        file.forEachRow(vector<size_t>(1, columns[0]), [&](const double* v) {
+            const double x = xTransform ? xTransform(v[0]) : v[0];
+            if (logX && x <= 0) return;
+            if (x < xMin) xMin = x;
+            if (x > xMax) xMax = x;
+        });
+    }
 
-        this->commandFile.close();
+    vector<vector<double>> dx(nSeries), dy(nSeries);
 
+    if (xMin < xMax) {
+        vector<MinMaxStream> reduced(nSeries, MinMaxStream(xMin, xMax, logX, this->decimationPixels));
+        file.forEachRow(columns, [&](const double* v) {
+            const double x = xTransform ? xTransform(v[0]) : v[0];
+            for (size_t k = 0; k < nSeries; ++k) reduced[k].add(x, yTransform ? yTransform(v[k+1]) : v[k+1]);
+        });
 
-        // execute gnuplot
-        executeGnuplot();
+        bool sorted = true;
+        for (size_t k = 0; k < nSeries; ++k) sorted = reduced[k].finish(dx[k], dy[k]) && sorted;
+        if (!sorted) cout << "[WARNING] x is not sorted, decimation of the file is approximate." << endl;
+    } else {
+        // a single x value: nothing to reduce
+        file.forEachRow(columns, [&](const double* v) {
+            for (size_t k = 0; k < nSeries; ++k) {
+                dx[k].push_back(xTransform ? xTransform(v[0]) : v[0]);
+                dy[k].push_back(yTransform ? yTransform(v[k+1]) : v[k+1]);
+            }
+        });
     }
-    else{
-        if(this->videoData.empty()) this->videoData = vector<vector<vector<double>>>(2);
-        this->videoData[0].push_back(y0);
-        this->videoData[1].push_back(y1);
+
+    return plotBlocks(vector<DataView>(dx.begin(), dx.end()), vector<DataView>(dy.begin(), dy.end()), titles, noLegend);
+
+}
+
+int GnuplotDriver::plotFileTransformed(const DataFile &file, const vector<size_t> &columns,
+                                       const function<double(double)> &xTransform, const function<double(double)> &yTransform,
+                                       const vector<string> &titles, const bool &noLegend) {
+
+    const size_t nSeries = columns.size() - 1;
+    const bool binary = binaryData();
+    size_t nRows = 0;
+
+    // rows are streamed from the mapping to gnuplot data, the file is never held in memory
+    const string source = writeData([&](ostream& out) {
+        if (binary) {
+            BinaryWriter writer(out);
+            file.forEachRow(columns, [&](const double* v) {
+                writer.reserve(columns.size());
+                writer.put(xTransform ? xTransform(v[0]) : v[0]);
+                for (size_t k = 1; k <= nSeries; ++k) writer.put(yTransform ? yTransform(v[k]) : v[k]);
+                ++nRows;
+            });
+        } else {
+            TextWriter writer(out, this->dataPrecision);
+            file.forEachRow(columns, [&](const double* v) {
+                writer.put(xTransform ? xTransform(v[0]) : v[0]);
+                for (size_t k = 1; k <= nSeries; ++k) {
+                    writer.put(' ');
+                    writer.put(yTransform ? yTransform(v[k]) : v[k]);
+                }
+                writer.put('\n');
+                ++nRows;
+            });
+        }
+    });
+
+    this->stats.pointsWritten += nRows;
+
+    if (nRows == 0) {
+        cout << "[WARNING] nothing to plot, the file has no rows." << endl;
+        finishStats(0);
+        return 0;
+    }
+
+    const string spec = binary ? binaryDataSpec(nRows, columns.size()) : "";
+    string plotCommand;
+    for (size_t k = 0; k < nSeries; ++k) {
+        plotCommand += (k == 0) ? "plot " : ", ";
+        plotCommand += source + spec + " u 1:" + to_string(k + 2) + this->plotOptions + getTitle(titles[k]);
     }
+    if (noLegend) plotCommand = "set nokey\n" + plotCommand;
+
+    return executeGnuplot(buildScript(plotCommand));
 
 }
 
-void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0,
-                         const vector<double>& x1, const vector<double>& y1,
-                         const vector<double>& x2, const vector<double>& y2) {
+// bins of a density plot around a single value: a decade on a log axis, a unit on a linear one
+static void widenBounds(double &min, double &max, const bool &log) {
+
+    if (min < max) return;
+    if (log) {
+        min /= sqrt(10.0);
+        max *= sqrt(10.0);
+    } else {
+        const double half = (min != 0) ? 0.5 * fabs(min) : 0.5;
+        min -= half;
+        max += half;
+    }
+
+}
+
+void GnuplotDriver::plotDensity(const DataView &x, const DataView &y, const DensityOptions &options) {
 
     if(this->action == gnuplot_action_type::GNUPLOT_NONE){
         cout << "[WARNING] gnuplot action is set to GNUPLOT_NONE." << endl;
         return;
     }
 
-    if(x0.size() != y0.size()){
-        cout<<"\n\n[ERROR] x0 and y0 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1)");
-    }
-    if(x1.size() != y1.size()){
-        cout<<"\n\n[ERROR] x1 and y1 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1)");
+    if(this->action == gnuplot_action_type::GNUPLOT_VIDEO){
+        cout << "[WARNING] density plots cannot be animation frames, plotDensity is ignored in GNUPLOT_VIDEO mode." << endl;
+        return;
     }
-    if(x2.size() != y2.size()){
-        cout<<"\n\n[ERROR] x2 and y2 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1, "
-                                 "const vector<double>& x2, const vector<double>& y2)");
+
+    if(x.size() != y.size()){
+        cout<<"\n\n[ERROR] x and y must have same dimension.\n\n"<<endl;
+        throw std::runtime_error("void GnuplotDriver::plotDensity(const DataView &x, const DataView &y, const DensityOptions &options)");
     }
 
-    bool noLegend = false;
-    if (this->legendTitles.empty()) {
-        legendTitles = vector<string>(3);
-        noLegend = true;
+    const bool logX = (this->axisType == gnuplot_axis_type::GNUPLOT_XLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+    const bool logY = (this->axisType == gnuplot_axis_type::GNUPLOT_YLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+
+    // bounds of the grid: the ranges set by the user or the ones of the points that can be plotted
+    double xMin = this->xRangeMin, xMax = this->xRangeMax;
+    double yMin = this->yRangeMin, yMax = this->yRangeMax;
+    {
+        // binning is the serialization of a density plot: it is timed as such
+        PhaseTimer timer(this->stats.serializeSeconds, this->statsOn);
+        if (!this->xRangeSet) {
+            const ValueRange range = parallelValueRange(x, logX, options.threads);
+            xMin = range.min;
+            xMax = range.max;
+        }
+        if (!this->yRangeSet) {
+            const ValueRange range = parallelValueRange(y, logY, options.threads);
+            yMin = range.min;
+            yMax = range.max;
+        }
     }
 
-    if(this->action != gnuplot_action_type::GNUPLOT_VIDEO) {
-        // creates (tmp) data file
-        ofstream tmp;
-        tmp.open(this->dataFileName, ios::trunc);
+    if (xMin > xMax || yMin > yMax) {
+        cout << "[WARNING] nothing to plot, no point can be plotted." << endl;
+        finishStats(0);
+        return;
+    }
+    widenBounds(xMin, xMax, logX);
+    widenBounds(yMin, yMax, logY);
 
-        for (int i = 0; i < x0.size(); ++i) {
-            tmp << x0[i] << " " << y0[i] << " " << x1[i] << " " << y1[i] << " " << x2[i] << " " << y2[i] << endl;
-        }
+    Histogram2D histogram(options.xBins, options.yBins, xMin, xMax, yMin, yMax, logX, logY);
+    {
+        PhaseTimer timer(this->stats.serializeSeconds, this->statsOn);
+        histogram.add(x, y, options.threads);
+    }
 
-        tmp.close();
+    plotDensity(histogram, options.logCounts);
 
-        if (noLegend) write_command("set nokey"); // hides legend
-        write_command(
-                "plot \"" + this->dataFileName + "\" u 1:2" + this->plotOptions + getTitle(legendTitles[0]) + ", '' u 3:4" + this->plotOptions + getTitle(legendTitles[1]) + ", '' u 5:6" + this->plotOptions + getTitle(legendTitles[2]));
+}
 
-        this->commandFile.close();
+void GnuplotDriver::plotDensity(const Histogram2D &histogram, const bool &logCounts) {
 
+    if(this->action == gnuplot_action_type::GNUPLOT_NONE){
+        cout << "[WARNING] gnuplot action is set to GNUPLOT_NONE." << endl;
+        return;
+    }
 
-        // execute gnuplot
-        executeGnuplot();
+    if(this->action == gnuplot_action_type::GNUPLOT_VIDEO){
+        cout << "[WARNING] density plots cannot be animation frames, plotDensity is ignored in GNUPLOT_VIDEO mode." << endl;
+        return;
     }
-    else{
-        if(this->videoData.empty()) this->videoData = vector<vector<vector<double>>>(3);
-        this->videoData[0].push_back(y0);
-        this->videoData[1].push_back(y1);
-        this->videoData[2].push_back(y2);
+
+    vector<string> titles;
+    const bool noLegend = seriesTitles(1, titles);
+
+    // images need evenly spaced pixels, on a log axis the grid is drawn as a pm3d surface seen from above
+    const bool image = !histogram.xLog() && !histogram.yLog() && this->axisType == gnuplot_axis_type::GNUPLOT_LINEAR;
+    const bool binary = image && binaryData();
+
+    const string source = writeData([&](ostream& out) {
+        if (!image) writeTextGrid(out, histogram, logCounts, this->dataPrecision);
+        else if (binary) writeBinaryImage(out, histogram, logCounts);
+        else writeTextImage(out, histogram, logCounts, this->dataPrecision);
+    });
+
+    this->stats.pointsWritten += image ? histogram.xBins() * histogram.yBins()
+                                       : (histogram.xBins() + 1) * (histogram.yBins() + 1);
+
+    string plotCommand = logCounts ? "set logscale cb\n" : "";
+    if (noLegend) plotCommand += "set nokey\n";
+    if (image) {
+        plotCommand += "plot " + source + (binary ? binaryImageSpec(histogram) + " u 1" : " u 1:2:3");
+        plotCommand += " with image" + getTitle(titles[0]);
+    } else {
+        plotCommand += "set view map\nset pm3d corners2color c1\n";
+        plotCommand += "splot " + source + " u 1:2:3 with pm3d" + getTitle(titles[0]);
     }
 
+    // color scale and view are global settings: they are restored for the next plots of a session
+    if (logCounts) plotCommand += "\nunset logscale cb";
+    if (!image) plotCommand += "\nunset pm3d\nset view 60,30,1,1";
+
+    executeGnuplot(buildScript(plotCommand));
+
 }
 
-void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0,
-                         const vector<double>& x1, const vector<double>& y1,
-                         const vector<double>& x2, const vector<double>& y2,
-                         const vector<double>& x3, const vector<double>& y3) {
+int GnuplotDriver::plotSeries(const vector<DataView> &x, const vector<DataView> &y) {
 
     if(this->action == gnuplot_action_type::GNUPLOT_NONE){
         cout << "[WARNING] gnuplot action is set to GNUPLOT_NONE." << endl;
-        return;
+        return 0;
     }
 
-    if(x0.size() != y0.size()){
-        cout<<"\n\n[ERROR] x0 and y0 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1)");
+    if(x.empty() || x.size() != y.size()){
+        cout<<"\n\n[ERROR] x and y must have same number of series.\n\n"<<endl;
+        throw std::runtime_error("int GnuplotDriver::plotSeries(const vector<DataView> &x, const vector<DataView> &y)");
     }
-    if(x1.size() != y1.size()){
-        cout<<"\n\n[ERROR] x1 and y1 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1)");
+    for (size_t i = 0; i < x.size(); ++i) {
+        if(x[i].size() != y[i].size()){
+            cout<<"\n\n[ERROR] x" << i << " and y" << i << " must have same dimension.\n\n"<<endl;
+            throw std::runtime_error("int GnuplotDriver::plotSeries(const vector<DataView> &x, const vector<DataView> &y)");
+        }
     }
-    if(x2.size() != y2.size()){
-        cout<<"\n\n[ERROR] x2 and y2 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1, "
-                                 "const vector<double>& x2, const vector<double>& y2)");
+
+    const size_t nSeries = x.size();
+
+    vector<string> titles;
+    const bool noLegend = seriesTitles(nSeries, titles);
+
+    if(this->action == gnuplot_action_type::GNUPLOT_VIDEO) {
+        this->frames.push(y);
+        return 0;
     }
-    if(x3.size() != y3.size()){
-        cout<<"\n\n[ERROR] x3 and y3 must have same dimension.\n\n"<<endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0, "
-                                 "const vector<double>& x1, const vector<double>& y1, "
-                                 "const vector<double>& x2, const vector<double>& y2, "
-                                 "const vector<double>& x3, const vector<double>& y3)");
+
+    vector<DataView> px = x, py = y;
+
+    // copies without the points a log axis cannot show, only filled if there are some
+    vector<vector<double>> plottableX, plottableY;
+    dropUnplottable(px, py, plottableX, plottableY);
+
+    // reduced copies of the series, only filled if decimation is active
+    vector<vector<double>> decimatedX, decimatedY;
+    if(this->decimation != gnuplot_decimation_type::GNUPLOT_NO_DECIMATION) decimate(px, py, decimatedX, decimatedY);
+
+    return plotBlocks(px, py, titles, noLegend);
+
+}
+
+PlotScene GnuplotDriver::scene(const vector<DataView> &x, const vector<DataView> &y,
+                               const vector<string> &titles, const bool &noLegend) const {
+
+    PlotScene scene;
+    scene.x = x;
+    scene.y = y;
+    scene.titles = titles;
+    scene.noLegend = noLegend;
+    scene.plotOptions = this->plotOptions;
+
+    scene.title = this->titleText;
+    scene.xLabel = this->xLabelText;
+    scene.yLabel = this->yLabelText;
+    scene.titleFont = this->titleFontSize;
+    scene.xLabelFont = this->xLabelFontSize;
+    scene.yLabelFont = this->yLabelFontSize;
+
+    scene.logX = (this->axisType == gnuplot_axis_type::GNUPLOT_XLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+    scene.logY = (this->axisType == gnuplot_axis_type::GNUPLOT_YLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+    scene.xRangeSet = this->xRangeSet;
+    scene.xMin = this->xRangeMin;
+    scene.xMax = this->xRangeMax;
+    scene.yRangeSet = this->yRangeSet;
+    scene.yMin = this->yRangeMin;
+    scene.yMax = this->yRangeMax;
+
+    if (this->saveWidth > 0) scene.width = this->saveWidth;
+    if (this->saveHeight > 0) scene.height = this->saveHeight;
+
+    return scene;
+
+}
+
+int GnuplotDriver::plotBlocks(const vector<DataView> &x, const vector<DataView> &y,
+                              const vector<string> &titles, const bool &noLegend) {
+
+    if (this->backend && this->action == gnuplot_action_type::GNUPLOT_SAVE && this->saveType == gnuplot_save_type::GNUPLOT_PNG) {
+        const PlotScene plot = scene(x, y, titles, noLegend);
+        if (this->backend->canRender(plot)) {
+            int status;
+            {
+                PhaseTimer timer(this->stats.runSeconds, this->statsOn);
+                status = this->backend->render(plot, this->saveName);
+            }
+            for (size_t i = 0; i < x.size(); ++i) this->stats.pointsWritten += x[i].size();
+            finishStats(status);
+            return status;
+        }
     }
 
+    // every series is a block of its own: text index blocks or consecutive binary records
+    const bool binary = binaryData();
+    string source = writeData([&](ostream& out) {
+        if (binary) writeBinarySeries(out, x, y);
+        else writeTextSeries(out, x, y, this->dataPrecision);
+    });
+
+    for (size_t i = 0; i < x.size(); ++i) this->stats.pointsWritten += x[i].size();
+
+    size_t block = 0;
+    size_t offset = 0;
+    const string plotCommand = seriesPlot(source, binary, x, titles, noLegend, block, offset);
+
+    if (plotCommand.empty()) {
+        cout << "[WARNING] nothing to plot, all the series are empty." << endl;
+        finishStats(0);
+        return 0;
+    }
+
+    // execute gnuplot
+    return executeGnuplot(buildScript(plotCommand));
+
+}
+
+bool GnuplotDriver::seriesTitles(const size_t &nSeries, vector<string> &titles) const {
+
+    // empty titles if no legend is set, the driver keeps its own settings for next plot
+    titles = this->legendTitles;
     bool noLegend = false;
-    if (this->legendTitles.empty()) {
-        legendTitles = vector<string>(4);
-        noLegend = true;
+    if (titles.size() < nSeries) {
+        noLegend = titles.empty();
+        titles.resize(nSeries);
     }
 
-    if(this->action != gnuplot_action_type::GNUPLOT_VIDEO) {
-        // creates (tmp) data file
-        ofstream tmp;
-        tmp.open(this->dataFileName, ios::trunc);
+    return noLegend;
+
+}
+
+string GnuplotDriver::seriesPlot(const string &source, const bool &binary, const vector<DataView> &x,
+                                 const vector<string> &titles, const bool &noLegend, size_t &block, size_t &offset) const {
+
+    string plotCommand;
+    bool first = true;
+
+    for (size_t i = 0; i < x.size(); ++i) {
+        // empty series are not written
+        if (x[i].empty()) continue;
+
+        plotCommand += first ? "plot " : ", ";
+        plotCommand += source;
+        plotCommand += binary ? binarySeriesSpec(x[i].size(), offset) : " index " + to_string(block);
+        plotCommand += " u 1:2" + this->plotOptions + getTitle(titles[i]);
+
+        offset += 2 * sizeof(double) * x[i].size();
+        ++block;
+        first = false;
+    }
+
+    if (first) return "";
 
-        for (int i = 0; i < x0.size(); ++i) {
-            tmp << x0[i] << " " << y0[i] << " " << x1[i] << " " << y1[i] << " " << x2[i] << " " << y2[i] << " " << x3[i] << " " << y3[i] << endl;
+    return noLegend ? "set nokey\n" + plotCommand : plotCommand; // hides legend
+
+}
+
+void GnuplotDriver::dropUnplottable(vector<DataView> &x, vector<DataView> &y,
+                                    vector<vector<double>> &px, vector<vector<double>> &py) {
+
+    const bool logX = (this->axisType == gnuplot_axis_type::GNUPLOT_XLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+    const bool logY = (this->axisType == gnuplot_axis_type::GNUPLOT_YLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+
+    // on linear axes nan and inf are left to gnuplot, that breaks lines on them
+    if (!logX && !logY) return;
+
+    // contiguous doubles are checked in place, other views a chunk at a time
+    const size_t chunk = DataView::chunkSize;
+    double bufferX[DataView::chunkSize], bufferY[DataView::chunkSize];
+
+    px.resize(x.size());
+    py.resize(y.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        const size_t n = x[i].size();
+
+        bool clean = true;
+        for (size_t start = 0; start < n && clean; start += chunk) {
+            const size_t count = std::min(chunk, n - start);
+            clean = firstUnplottable(x[i].read(start, count, bufferX), y[i].read(start, count, bufferY), count, logX, logY) == count;
+        }
+        if (clean) continue;
+
+        px[i].resize(n);
+        py[i].resize(n);
+        size_t kept = 0;
+        for (size_t start = 0; start < n; start += chunk) {
+            const size_t count = std::min(chunk, n - start);
+            kept += keepPlottable(x[i].read(start, count, bufferX), y[i].read(start, count, bufferY), count, logX, logY,
+                                  px[i].data() + kept, py[i].data() + kept);
         }
+        px[i].resize(kept);
+        py[i].resize(kept);
 
-        tmp.close();
+        x[i] = DataView(px[i]);
+        y[i] = DataView(py[i]);
+    }
 
-        if (noLegend) write_command("set nokey"); // hides legend
-        write_command(
-                "plot \"" + this->dataFileName + "\" u 1:2" + this->plotOptions + getTitle(legendTitles[0]) + ", '' u 3:4" + this->plotOptions + getTitle(legendTitles[1]) + ", '' u 5:6" + this->plotOptions + getTitle(legendTitles[2]) + ", '' u 7:8" + this->plotOptions + getTitle(legendTitles[3]));
+}
 
-        this->commandFile.close();
+void GnuplotDriver::decimate(vector<DataView> &x, vector<DataView> &y,
+                             vector<vector<double>> &dx, vector<vector<double>> &dy) {
 
+    const bool logX = (this->axisType == gnuplot_axis_type::GNUPLOT_XLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+    const bool logY = (this->axisType == gnuplot_axis_type::GNUPLOT_YLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
 
-        // execute gnuplot
-        executeGnuplot();
+    // range of the x axis: the one set by the user or the one gnuplot will compute from data
+    double xMin = this->xRangeMin;
+    double xMax = this->xRangeMax;
+    if (!this->xRangeSet) {
+        ValueRange range;
+        for (size_t i = 0; i < x.size(); ++i) range.merge(valueRange(x[i], logX));
+        xMin = range.min;
+        xMax = range.max;
     }
-    else{
-        if(this->videoData.empty()) this->videoData = vector<vector<vector<double>>>(4);
-        this->videoData[0].push_back(y0);
-        this->videoData[1].push_back(y1);
-        this->videoData[2].push_back(y2);
-        this->videoData[3].push_back(y2);
+    if (xMin >= xMax) return;
+
+    const size_t pixels = this->decimationPixels;
+
+    dx.resize(x.size());
+    dy.resize(y.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        // already less points than what decimation would keep
+        if (x[i].size() <= 4 * pixels) continue;
+
+        if (this->decimation == gnuplot_decimation_type::GNUPLOT_LTTB)
+            decimateLTTB(x[i], y[i], xMin, xMax, logX, logY, 2 * pixels, dx[i], dy[i]);
+        else
+            decimateMinMax(x[i], y[i], xMin, xMax, logX, pixels, dx[i], dy[i]);
+
+        x[i] = DataView(dx[i]);
+        y[i] = DataView(dy[i]);
     }
 
 }
 
-void GnuplotDriver::write_action_save() {
+shared_ptr<GnuplotDriver> GnuplotDriver::snapshot(const gnuplot_action_type &actionType, const string &fileName) {
+
+    shared_ptr<GnuplotDriver> job = make_shared<GnuplotDriver>(this->axisType, actionType, fileName, this->saveType);
+
+    job->commands = this->commands;
+    job->plotOptions = this->plotOptions;
+    job->saveWidth = this->saveWidth;
+    job->saveHeight = this->saveHeight;
+    job->titleText = this->titleText;
+    job->xLabelText = this->xLabelText;
+    job->yLabelText = this->yLabelText;
+    job->titleFontSize = this->titleFontSize;
+    job->xLabelFontSize = this->xLabelFontSize;
+    job->yLabelFontSize = this->yLabelFontSize;
+    job->yRangeSet = this->yRangeSet;
+    job->yRangeMin = this->yRangeMin;
+    job->yRangeMax = this->yRangeMax;
+    job->backend = this->backend;
+    job->legendTitles = this->legendTitles;
+    job->dataFormat = this->dataFormat;
+    job->dataTransport = this->dataTransport;
+    job->dataPrecision = this->dataPrecision;
+    job->decimation = this->decimation;
+    job->decimationPixels = this->decimationPixels;
+    job->xRangeSet = this->xRangeSet;
+    job->xRangeMin = this->xRangeMin;
+    job->xRangeMax = this->xRangeMax;
+    job->session = this->session;
+    job->server = this->server;
+    job->statsOn = this->statsOn;
+    job->statsCallback = this->statsCallback;
+    job->renderCache = this->renderCache;
+
+    return job;
+
+}
+
+future<int> GnuplotDriver::queueJob(const shared_ptr<GnuplotDriver> &job, vector<vector<double>> &&x, vector<vector<double>> &&y) {
+
+    if (!this->renderQueue) this->renderQueue = make_shared<RenderQueue>();
+
+    // data is owned by the job until it has been rendered
+    auto data = make_shared<pair<vector<vector<double>>, vector<vector<double>>>>(move(x), move(y));
+
+    return this->renderQueue->push([job, data]() {
+        return job->plotSeries(vector<DataView>(data->first.begin(), data->first.end()),
+                               vector<DataView>(data->second.begin(), data->second.end()));
+    });
+
+}
+
+future<int> GnuplotDriver::plotAsync(vector<double> x, vector<double> y) {
+
+    vector<vector<double>> xs(1), ys(1);
+    xs[0] = move(x);
+    ys[0] = move(y);
+
+    return plotAsync(move(xs), move(ys));
+
+}
+
+future<int> GnuplotDriver::plotAsync(vector<vector<double>> x, vector<vector<double>> y) {
+
+    if(this->action == gnuplot_action_type::GNUPLOT_NONE || this->action == gnuplot_action_type::GNUPLOT_VIDEO){
+        // nothing to render: frames are stored right away
+        plot(x, y);
+        promise<int> status;
+        status.set_value(0);
+        return status.get_future();
+    }
+
+    return queueJob(snapshot(this->action, this->saveName), move(x), move(y));
+
+}
+
+future<int> GnuplotDriver::saveAsync(const string &fileName, vector<double> x, vector<double> y) {
+
+    vector<vector<double>> xs(1), ys(1);
+    xs[0] = move(x);
+    ys[0] = move(y);
+
+    return saveAsync(fileName, move(xs), move(ys));
+
+}
+
+future<int> GnuplotDriver::saveAsync(const string &fileName, vector<vector<double>> x, vector<vector<double>> y) {
+
+    return queueJob(snapshot(gnuplot_action_type::GNUPLOT_SAVE, fileName), move(x), move(y));
+
+}
+
+string GnuplotDriver::write_action_save() {
+
+    string lines;
 
     switch(this->saveType){
     case gnuplot_save_type::GNUPLOT_EPS:
-            write_command("set term epscairo");
+            lines += "set term epscairo\n";
             break;
     case gnuplot_save_type::GNUPLOT_PNG:
-            write_command("set term png");
+            lines += "set term png";
+            if (this->saveWidth > 0 && this->saveHeight > 0)
+                lines += " size " + to_string(this->saveWidth) + "," + to_string(this->saveHeight);
+            lines += "\n";
             break;
         default:
             cout<<"\n\n[ERROR] wrong output file type.\n\n"<<endl;
-            throw std::runtime_error("void GnuplotDriver::write_action_save()");
+            throw std::runtime_error("string GnuplotDriver::write_action_save()");
+    }
+
+    lines += "set output \"" + this->saveName + "\"\n";
+
+    return lines;
+
+}
+
+string GnuplotDriver::axisSettings() const {
+
+    string settings;
+
+    switch (axisType) {
+    case gnuplot_axis_type::GNUPLOT_XLOG:
+      settings += "set logscale x\n";
+      break;
+    case gnuplot_axis_type::GNUPLOT_YLOG:
+      settings += "set logscale y\n";
+      break;
+    case gnuplot_axis_type::GNUPLOT_LOGLOG:
+      settings += "set logscale xy\n";
+      break;
+    default:
+      break;
+    }
+
+    settings += this->commands;
+
+    return settings;
+
+}
+
+string GnuplotDriver::buildScript(const string &plotCommand) {
+
+    string script;
+
+    if(this->action == gnuplot_action_type::GNUPLOT_SAVE) script += write_action_save();
+
+    script += axisSettings();
+    script += this->dataBlock;
+    script += plotCommand;
+    script += '\n';
+
+    // a session outlives the plot: close the exported file and go back to the default terminal
+    if((this->session || this->server) && this->action == gnuplot_action_type::GNUPLOT_SAVE) script += "unset output\nset term pop\n";
+
+    this->dataBlock.clear();
+
+    return script;
+
+}
+
+string GnuplotDriver::writeFrames(const DataView &x, string &settings) {
+
+    const size_t nFrames = this->frames.frames();
+    const size_t nCurves = this->frames.curves();
+    const size_t nPoints = this->frames.points();
+
+    if (nFrames == 0 || nCurves == 0) {
+        cout << "[WARNING] no frame to play." << endl;
+        return "";
+    }
+    if (x.size() != nPoints) {
+        cout<<"\n\n[ERROR] x must have same dimension as the frames.\n\n"<<endl;
+        throw std::runtime_error("string GnuplotDriver::writeFrames(const DataView &x, string &settings)");
+    }
+
+    // frames are written in storage order, the range of every curve is found on the way
+    const bool logY = (this->axisType == gnuplot_axis_type::GNUPLOT_YLOG || this->axisType == gnuplot_axis_type::GNUPLOT_LOGLOG);
+    ValueRange range;
+    this->frames.adviseSequential();
+
+    const bool binary = binaryData();
+    string source = writeData([&](ostream& out) {
+        if (binary) writeBinaryFrames(out, x, this->frames, range, logY);
+        else writeTextFrames(out, x, this->frames, range, logY, this->dataPrecision);
+    });
+    this->stats.pointsWritten += nFrames * nPoints;
+
+    settings = "set nokey\n";
+    const double min = range.min;
+    const double max = range.max;
+    if (range.count > 0 && logY) {
+        // 5% of the decades shown on each side
+        const double factor = (max > min) ? pow(max / min, 0.05) : 2;
+        settings += "set yrange [" + formatNumber(min / factor) + " : " + formatNumber(max * factor) + "]\n";
+    } else if (range.count > 0) {
+        const double margin = (max > min) ? 0.05 * (max - min) : ((max != 0) ? 0.05 * fabs(max) : 1);
+        settings += "set yrange [" + formatNumber(min - margin) + " : " + formatNumber(max + margin) + "]\n";
+    }
+
+    // frame t is block t of text data, or rows t*nPoints to (t+1)*nPoints-1 of binary data
+    string frame;
+    if (binary) {
+        source += binaryDataSpec(nFrames * nPoints, nCurves + 1);
+        frame = " every ::(t*" + to_string(nPoints) + ")::(t*" + to_string(nPoints) + "+" + to_string(nPoints - 1) + ")";
+    } else {
+        frame = " index t";
+    }
+
+    string plotCommand;
+    for (size_t k = 0; k < nCurves; ++k) {
+        plotCommand += (k == 0) ? "plot " : ", ";
+        plotCommand += source + frame + " u 1:" + to_string(k + 2) + this->plotOptions;
     }
 
-    write_command("set output \"" + this->saveName + "\"");
+    return plotCommand;
 
 }
 
-void GnuplotDriver::playAnimation(const vector<double> &x, const double &dt) {
+void GnuplotDriver::playAnimation(const DataView &x, const double &dt) {
 
     if(this->action != gnuplot_action_type::GNUPLOT_VIDEO){
         cout << "[WARNING] calling function GnuplotDriver::playAnimation\n"
@@ -371,71 +1054,317 @@ void GnuplotDriver::playAnimation(const vector<double> &x, const double &dt) {
         return;
     }
 
-    ofstream tmp;
-    tmp.open(this->dataFileName, ios::trunc);
+    string plotCommand;
+    string framePlot = writeFrames(x, plotCommand);
+    if (framePlot.empty()) {
+        finishStats(0);
+        return;
+    }
+
+    plotCommand += "do for [t=0:" + to_string(this->frames.frames()-1) + "] {\n";
+    plotCommand += framePlot + "\n";
+    plotCommand += "pause " + formatNumber(dt) + "\n";
+    plotCommand += "}";
 
-    for (int i = 0; i < x.size(); ++i) {
-        tmp << x[i] << " ";
-        for (int j = 0; j < this->videoData[0].size(); ++j) {
-            for (int k = 0; k < this->videoData.size(); ++k) {
-                tmp << this->videoData[k][j][i] << " ";
+    // execute gnuplot
+    executeGnuplot(buildScript(plotCommand));
+}
+
+// runs a program and waits for it, returns its exit status (127 if it could not be executed)
+static int runProgram(const vector<string>& args) {
+
+    vector<char*> argv;
+    for (size_t i = 0; i < args.size(); ++i) argv.push_back(const_cast<char*>(args[i].c_str()));
+    argv.push_back(NULL);
+
+    pid_t child = fork();
+    int status = 0;
+
+    if (child < 0) {
+        return -1;
+    } else if (child == 0) {
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    while (waitpid(child, &status, 0) < 0 && errno == EINTR);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+}
+
+AnimationExportStats GnuplotDriver::exportAnimation(const DataView &x, const string &fileName,
+                                                    const AnimationExportOptions &options) {
+
+    AnimationExportStats stats;
+
+    if(this->action != gnuplot_action_type::GNUPLOT_VIDEO){
+        cout << "[WARNING] calling function GnuplotDriver::exportAnimation\n"
+                "but gnuplot action is not set to GNUPLOT_VIDEO." << endl;
+        stats.status = -1;
+        return stats;
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    // data is written once and read by every gnuplot. Those are local: frames are written here even
+    // if a server is set, and in a memory file rather than in a datablock every chunk would send again.
+    // Server and transport are put back once they are written
+    shared_ptr<PlotClient> server;
+    server.swap(this->server);
+    const gnuplot_data_transport transport = this->dataTransport;
+    if (transport == gnuplot_data_transport::GNUPLOT_DATABLOCK) this->dataTransport = gnuplot_data_transport::GNUPLOT_MEMFD;
+    string settings, framePlot, base;
+    try {
+        framePlot = writeFrames(x, settings);
+        if (!framePlot.empty()) base = buildScript(settings);
+    } catch (...) {
+        this->server.swap(server);
+        this->dataTransport = transport;
+        throw;
+    }
+    this->server.swap(server);
+    this->dataTransport = transport;
+    if (framePlot.empty()) {
+        finishStats(0);
+        return stats;
+    }
+
+    const size_t nFrames = this->frames.frames();
+    size_t nThreads = (options.threads > 0) ? options.threads : thread::hardware_concurrency();
+    if (nThreads == 0) nThreads = 1;
+    // more chunks than threads, so that threads finishing early get more work
+    const size_t nChunks = std::min(nFrames, 4 * nThreads);
+    nThreads = std::min(nThreads, nChunks);
+
+    const char* tmpDir = getenv("TMPDIR");
+    string dir = string((tmpDir && *tmpDir) ? tmpDir : "/tmp") + "/simplePlot_animation_XXXXXX";
+    if (!mkdtemp(&dir[0])) {
+        cout<<"\n\n[ERROR] could not create directory for animation frames.\n\n"<<endl;
+        throw std::runtime_error("AnimationExportStats GnuplotDriver::exportAnimation(const DataView &x, const string &fileName,\n"
+                                 "                                                    const AnimationExportOptions &options)");
+    }
+
+    const bool gif = (options.format == gnuplot_animation_format::GNUPLOT_GIF);
+    const string size = " size " + to_string(options.width) + "," + to_string(options.height);
+    const string framePrefix = (options.format == gnuplot_animation_format::GNUPLOT_PNG_FRAMES) ? fileName : dir + "/frame";
+
+    vector<string> chunkFiles(nChunks);
+    for (size_t c = 0; c < nChunks; ++c) {
+        char name[32];
+        snprintf(name, sizeof(name), "/chunk_%05zu.gif", c);
+        chunkFiles[c] = dir + name;
+    }
+
+    atomic<size_t> nextChunk(0);
+    mutex progressLock;
+    size_t framesDone = 0;
+    int status = 0;
+
+    auto work = [&]() {
+        // one gnuplot per thread, reused for all the chunks the thread renders
+        GnuplotSession gnuplot(false);
+        size_t c;
+        while ((c = nextChunk++) < nChunks) {
+            const size_t first = c * nFrames / nChunks;
+            const size_t last = (c + 1) * nFrames / nChunks;
+
+            string script = base;
+            if (gif) {
+                script += "set term gif animate delay " + to_string((int) (options.dt * 100 + 0.5)) + size + "\n";
+                script += "set output \"" + chunkFiles[c] + "\"\n";
+            } else {
+                script += "set term png" + size + "\n";
+            }
+            script += "do for [t=" + to_string(first) + ":" + to_string(last - 1) + "] {\n";
+            if (!gif) script += "set output sprintf(\"" + framePrefix + "_%06d.png\", t)\n";
+            script += framePlot + "\n}\nunset output\n";
+
+            int chunkStatus;
+            try {
+                chunkStatus = gnuplot.run(script);
+            } catch (std::exception&) {
+                chunkStatus = -1;
             }
+
+            lock_guard<mutex> guard(progressLock);
+            if (chunkStatus != 0) status = chunkStatus;
+            framesDone += last - first;
+            if (options.progress) options.progress(framesDone, nFrames);
         }
-        tmp << endl;
+    };
+
+    {
+        // gnuplot processes start and run in parallel: both are counted as run time
+        PhaseTimer timer(this->stats.runSeconds, this->statsOn);
+        vector<thread> workers;
+        for (size_t t = 0; t < nThreads; ++t) workers.push_back(thread(work));
+        for (size_t t = 0; t < nThreads; ++t) workers[t].join();
     }
 
-    tmp.close();
+    bool keepDir = false;
 
-    int nCurves = this->videoData.size();
-    int nFrames = this->videoData[0].size();
+    if (status == 0 && gif) {
+        if (!stitchGifs(chunkFiles, fileName)) {
+            cout << "\n\n[ERROR] could not join animation chunks in " << fileName << ".\n\n" << endl;
+            status = -1;
+        }
+    } else if (status == 0 && options.format == gnuplot_animation_format::GNUPLOT_MP4) {
+        const string fps = formatNumber(options.dt > 0 ? 1.0 / options.dt : 10.0);
+        status = runProgram({"ffmpeg", "-y", "-loglevel", "error", "-framerate", fps,
+                             "-i", framePrefix + "_%06d.png", "-vf", "pad=ceil(iw/2)*2:ceil(ih/2)*2",
+                             "-pix_fmt", "yuv420p", fileName});
+        if (status == 127) {
+            cout << "[WARNING] ffmpeg not found, frames are left in " << dir << endl;
+            keepDir = true;
+        }
+    }
 
-    // find bounding box for computed data
-    double min = 999;
-    double max = -999;
-    for (int i = 0; i < this->videoData[0].size(); ++i) {
-        for (int j = 0; j < this->videoData[0][i].size(); ++j) {
-            if (this->videoData[0][i][j] < min) min = this->videoData[0][i][j];
-            if (this->videoData[0][i][j] > max) max = this->videoData[0][i][j];
+    if (!keepDir) {
+        for (size_t c = 0; c < nChunks; ++c) unlink(chunkFiles[c].c_str());
+        if (options.format == gnuplot_animation_format::GNUPLOT_MP4) {
+            for (size_t t = 0; t < nFrames; ++t) {
+                char name[32];
+                snprintf(name, sizeof(name), "_%06zu.png", t);
+                unlink((framePrefix + name).c_str());
+            }
         }
+        rmdir(dir.c_str());
     }
-    min -= (max > 0) ? (max*0.05) : (-max*0.05);
-    max += (max > 0) ? (max*0.05) : (-max*0.05);
 
-    write_command("set nokey");
-    write_command("do for [t=2:" + to_string(nFrames+1) + "] {");
-    write_command("set yrange [" + to_string(min) + " : " + to_string(max) + "]");
-    if (nCurves == 1)
-        write_command("plot \"" + this->dataFileName + "\" u 1:t" + this->plotOptions);
-    else if (nCurves == 2)
-        write_command("plot \"" + this->dataFileName + "\" u 1:2*t-2" + this->plotOptions + ", '' u 1:2*t-1" + this->plotOptions);
+    stats.frames = nFrames;
+    stats.chunks = nChunks;
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.framesPerSecond = (stats.seconds > 0) ? nFrames / stats.seconds : 0;
+    stats.status = status;
 
-    write_command("pause " + to_string(dt));
+    finishStats(status);
 
-    write_command("}");
+    return stats;
 
-    this->commandFile.close();
+}
+
+int GnuplotDriver::executeGnuplot(const string& script) {
+
+    this->stats.commandBytes += script.size();
+
+    // streamed data is not hashed: only plots written by writeData can be cached
+    const bool cached = this->renderCache && this->dataHashed && this->action == gnuplot_action_type::GNUPLOT_SAVE;
+    this->dataHashed = false;
+
+    uint64_t key = 0;
+    if (cached) {
+        key = cacheKey(script);
+        if (this->renderCache->fetch(key, this->saveName)) {
+            this->stats.cacheHit = true;
+            finishStats(0);
+            return 0;
+        }
+    }
+
+    const int status = runGnuplot(script);
+
+    if (cached && status == 0) this->renderCache->store(key, this->saveName);
+
+    finishStats(status);
+
+    return status;
 
-    // execute gnuplot
-    executeGnuplot();
 }
 
-void GnuplotDriver::executeGnuplot() {
+uint64_t GnuplotDriver::cacheKey(const string &script) const {
+
+    // data file and exported file names do not matter, only what is plotted and how
+    string normalized = script;
+    const string names[] = {this->dataSource, "\"" + this->saveName + "\""};
+    const string placeholders[] = {"$SP_SOURCE", "$SP_OUTPUT"};
+    for (int k = 0; k < 2; ++k) {
+        if (names[k].empty()) continue;
+        size_t pos = 0;
+        while ((pos = normalized.find(names[k], pos)) != string::npos) {
+            normalized.replace(pos, names[k].size(), placeholders[k]);
+            pos += placeholders[k].size();
+        }
+    }
 
-    pid_t child = fork();
-    pid_t wpid;
+    Hasher64 hasher(this->dataHasher.digest());
+    hasher.update(normalized.data(), normalized.size());
+    return hasher.digest();
+
+}
+
+int GnuplotDriver::runGnuplot(const string& script) {
+
+    if (this->server) {
+        PhaseTimer timer(this->stats.runSeconds, this->statsOn);
+        const int status = this->server->run(script, this->serverData);
+        this->serverData.clear();
+        return status;
+    }
+
+    if (this->session) {
+        PhaseTimer timer(this->stats.runSeconds, this->statsOn);
+        return this->session->run(script);
+    }
+
+    if (this->dataTransport != gnuplot_data_transport::GNUPLOT_FILE) {
+        // no command file either: a gnuplot living just for this script reads it from a pipe
+        GnuplotSession oneShot;
+        {
+            PhaseTimer timer(this->stats.spawnSeconds, this->statsOn);
+            oneShot.restart();
+        }
+        PhaseTimer timer(this->stats.runSeconds, this->statsOn);
+        return oneShot.run(script);
+    }
+
+    {
+        PhaseTimer timer(this->stats.commandSeconds, this->statsOn);
+        makeSessionDir();
+        ofstream commandFile;
+        commandFile.open(this->commandFileName, ios::trunc);
+        commandFile << script;
+        commandFile.close();
+    }
+
+    pid_t child;
+    {
+        PhaseTimer timer(this->stats.spawnSeconds, this->statsOn);
+        child = fork();
+    }
     int status = 0;
 
     if (child < 0) {
         cout << "\n\n[ERROR] could not fork process.\n\n" << endl;
-        throw std::runtime_error("void GnuplotDriver::plot(const vector<double>& x0, const vector<double>& y0,\n"
-                                 "                         const vector<double>& x1, const vector<double>& y1)");
+        throw std::runtime_error("int GnuplotDriver::runGnuplot(const string& script)");
     } else if (child == 0) {
         // executes gnuplot
         execlp("gnuplot", "gnuplot", this->commandFileName.c_str(), "--persist", (char *) NULL);
+        _exit(127);
     } else {
-        //main, wait for child
-        while ((wpid = wait(&status)) > 0);
+        //main, wait for child (other children, i.e. sessions, are not ours to reap)
+        PhaseTimer timer(this->stats.runSeconds, this->statsOn);
+        while (waitpid(child, &status, 0) < 0 && errno == EINTR);
+    }
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+void GnuplotDriver::finishStats(const int &status) {
+
+    this->stats.status = status;
+    if (this->statsOn) {
+        this->previousStats = this->stats;
+        if (this->statsCallback) this->statsCallback(this->previousStats);
     }
+    this->stats = PlotStats();
+
+}
+
+void GnuplotDriver::setStats(const bool &enabled, const function<void(const PlotStats&)> &callback) {
+
+    this->statsOn = enabled;
+    this->statsCallback = callback;
+
 }
 
 void GnuplotDriver::setLegendTitles(const vector<string>& ss){
@@ -448,3 +1377,240 @@ void GnuplotDriver::setAxisType(const gnuplot_axis_type &axis) {
     axisType = axis;
 
 }
+
+void GnuplotDriver::setDataFormat(const gnuplot_data_format &format) {
+
+    this->dataFormat = format;
+
+}
+
+void GnuplotDriver::setDataTransport(const gnuplot_data_transport &transport) {
+
+    this->dataTransport = transport;
+
+}
+
+void GnuplotDriver::setPrecision(const int &digits) {
+
+    this->dataPrecision = digits;
+
+}
+
+void GnuplotDriver::setDecimation(const gnuplot_decimation_type &type, const size_t &pixels) {
+
+    this->decimation = type;
+    this->decimationPixels = (pixels > 0) ? pixels : 640;
+
+}
+
+void GnuplotDriver::setFrameStoreLimit(const size_t &bytes) {
+
+    this->frames.setSpillThreshold(bytes);
+
+}
+
+void GnuplotDriver::setSaveName(const string &fileName) {
+
+    this->saveName = fileName;
+
+}
+
+void GnuplotDriver::setSaveSize(const size_t &width, const size_t &height) {
+
+    this->saveWidth = width;
+    this->saveHeight = height;
+
+}
+
+void GnuplotDriver::setBackend(const shared_ptr<PlotBackend> &b) {
+
+    this->backend = b;
+
+}
+
+void GnuplotDriver::setStreaming(const size_t &capacity, const double &maxFps) {
+
+    this->streamCapacity = (capacity > 0) ? capacity : 1;
+    this->streamPeriod = (maxFps > 0) ? 1.0 / maxFps : 0;
+    this->streams.clear();
+    this->streamSent.clear();
+
+    // the data file is rewritten from scratch with the new layout
+    if (this->dataFd >= 0) close(this->dataFd);
+    this->dataFd = -1;
+
+    if (!this->session) this->session = make_shared<GnuplotSession>();
+
+}
+
+void GnuplotDriver::push(const size_t &series, const double &x, const double &y) {
+
+    if (this->streamCapacity == 0) {
+        cout << "[WARNING] calling function GnuplotDriver::push\n"
+                "but streaming is not set, see GnuplotDriver::setStreaming." << endl;
+        return;
+    }
+
+    if (series >= this->streams.size()) {
+        this->streams.resize(series + 1, RingBuffer(this->streamCapacity));
+        this->streamSent.resize(series + 1, 0);
+    }
+    this->streams[series].push(x, y);
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - this->lastRefresh;
+    if (elapsed.count() >= this->streamPeriod) refresh();
+
+}
+
+string GnuplotDriver::writeStreamUpdates() {
+
+    PhaseTimer timer(this->stats.serializeSeconds, this->statsOn);
+
+    if (this->dataFd < 0) {
+#ifdef MFD_CLOEXEC
+        if (this->dataTransport == gnuplot_data_transport::GNUPLOT_MEMFD)
+            this->dataFd = memfd_create("simplePlot_stream", MFD_CLOEXEC);
+        else
+#endif
+        {
+            makeSessionDir();
+            this->dataFd = open(this->dataFileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        }
+
+        if (this->dataFd < 0) {
+            cout<<"\n\n[ERROR] could not create data file for streaming.\n\n"<<endl;
+            throw std::runtime_error("string GnuplotDriver::writeStreamUpdates()");
+        }
+    }
+    string source = "\"" + this->dataFileName + "\"";
+    if (this->dataTransport == gnuplot_data_transport::GNUPLOT_MEMFD)
+        source = "\"/proc/" + to_string(getpid()) + "/fd/" + to_string(this->dataFd) + "\"";
+
+    const size_t capacity = this->streamCapacity;
+    const size_t region = 4 * capacity * sizeof(double);
+
+    for (size_t s = 0; s < this->streams.size(); ++s) {
+        const RingBuffer& stream = this->streams[s];
+        const unsigned long long fresh = min<unsigned long long>(stream.total() - this->streamSent[s], capacity);
+        const size_t first = (size_t) ((stream.total() - fresh) % capacity);
+
+        // slots changed, in both halves of the ring, before and after wrapping
+        auto writeSlots = [&](const size_t& slot, const size_t& n) {
+            const char* p = reinterpret_cast<const char*>(stream.slots() + 2 * slot);
+            size_t bytes = 2 * n * sizeof(double);
+            off_t offset = s * region + 2 * slot * sizeof(double);
+            while (bytes > 0) {
+                ssize_t w = pwrite(this->dataFd, p, bytes, offset);
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    cout<<"\n\n[ERROR] could not write streaming data.\n\n"<<endl;
+                    throw std::runtime_error("string GnuplotDriver::writeStreamUpdates()");
+                }
+                p += w;
+                bytes -= w;
+                offset += w;
+            }
+        };
+        const size_t beforeWrap = min<size_t>(fresh, capacity - first);
+        writeSlots(first, beforeWrap);
+        writeSlots(first + capacity, beforeWrap);
+        writeSlots(0, fresh - beforeWrap);
+        writeSlots(capacity, fresh - beforeWrap);
+
+        this->stats.pointsWritten += fresh;
+        this->stats.dataBytes += 4 * fresh * sizeof(double);
+
+        this->streamSent[s] = stream.total();
+    }
+
+    return source;
+
+}
+
+int GnuplotDriver::refresh() {
+
+    this->lastRefresh = chrono::steady_clock::now();
+
+    const size_t nSeries = this->streams.size();
+    if (nSeries == 0) return 0;
+
+    vector<string> titles;
+    const bool noLegend = seriesTitles(nSeries, titles);
+
+    // binary data file: only new samples are written. Datablocks: the samples held are sent as text
+    const bool update = (this->dataTransport != gnuplot_data_transport::GNUPLOT_DATABLOCK) && hostIsLittleEndian();
+
+    string source;
+    if (update) {
+        source = writeStreamUpdates();
+    } else {
+        source = writeData([&](ostream& out) {
+            TextWriter writer(out, this->dataPrecision);
+            bool first = true;
+            for (size_t s = 0; s < nSeries; ++s) {
+                const RingBuffer& stream = this->streams[s];
+                if (stream.size() == 0) continue;
+                if (!first) {
+                    writer.put('\n');
+                    writer.put('\n');
+                }
+                first = false;
+                const double* w = stream.window();
+                this->stats.pointsWritten += stream.size();
+                for (size_t i = 0; i < stream.size(); ++i) {
+                    writer.put(w[2*i]);
+                    writer.put(' ');
+                    writer.put(w[2*i+1]);
+                    writer.put('\n');
+                }
+            }
+        });
+    }
+
+    string plotCommand = noLegend ? "set nokey\n" : ""; // hides legend
+    size_t block = 0;
+    for (size_t s = 0; s < nSeries; ++s) {
+        const RingBuffer& stream = this->streams[s];
+        if (stream.size() == 0) continue;
+
+        const size_t offset = s * 4 * this->streamCapacity * sizeof(double) + 2 * stream.windowStart() * sizeof(double);
+
+        plotCommand += (block == 0) ? "plot " : ", ";
+        plotCommand += source;
+        plotCommand += update ? binarySeriesSpec(stream.size(), offset) : " index " + to_string(block);
+        plotCommand += " u 1:2" + this->plotOptions + getTitle(titles[s]);
+        ++block;
+    }
+
+    if (block == 0) {
+        finishStats(0);
+        return 0;
+    }
+
+    return executeGnuplot(buildScript(plotCommand));
+
+}
+
+void GnuplotDriver::setRenderCache(const shared_ptr<RenderCache> &cache) {
+
+    this->renderCache = cache;
+
+}
+
+void GnuplotDriver::setRenderQueue(const shared_ptr<RenderQueue> &q) {
+
+    this->renderQueue = q ? q : make_shared<RenderQueue>();
+
+}
+
+void GnuplotDriver::setSession(const shared_ptr<GnuplotSession> &s) {
+
+    this->session = s ? s : make_shared<GnuplotSession>();
+
+}
+
+void GnuplotDriver::setServer(const shared_ptr<PlotClient> &c) {
+
+    this->server = c;
+
+}
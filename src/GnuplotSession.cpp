@@ -0,0 +1,218 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "GnuplotSession.h"
+#include <iostream>
+#include <stdexcept>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+GnuplotSession::GnuplotSession(bool persist) {
+
+    this->pid = -1;
+    this->fd = -1;
+    this->persist = persist;
+    this->nScripts = 0;
+    this->nStarts = 0;
+
+}
+
+GnuplotSession::~GnuplotSession() {
+
+    if (this->pid > 0) stop();
+
+}
+
+void GnuplotSession::start() {
+
+    // a socket instead of a pipe: writing to a dead gnuplot must not raise SIGPIPE (see MSG_NOSIGNAL)
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+        cout << "\n\n[ERROR] could not create socket for gnuplot session.\n\n" << endl;
+        throw std::runtime_error("void GnuplotSession::start()");
+    }
+
+    pid_t child = fork();
+
+    if (child < 0) {
+        ::close(sv[0]);
+        ::close(sv[1]);
+        cout << "\n\n[ERROR] could not fork process.\n\n" << endl;
+        throw std::runtime_error("void GnuplotSession::start()");
+    } else if (child == 0) {
+        // gnuplot reads commands from stdin and prints the markers on stdout
+        dup2(sv[1], STDIN_FILENO);
+        dup2(sv[1], STDOUT_FILENO);
+        if (this->persist)
+            execlp("gnuplot", "gnuplot", "--persist", (char *) NULL);
+        else
+            execlp("gnuplot", "gnuplot", (char *) NULL);
+        _exit(127);
+    }
+
+    ::close(sv[1]);
+    this->fd = sv[0];
+    this->pid = child;
+    this->readBuffer.clear();
+    ++this->nStarts;
+
+    // saves the default terminal, scripts exporting a file restore it with "set term pop"
+    const string init = "set term push\n";
+    writeAll(init.c_str(), init.size());
+
+}
+
+int GnuplotSession::stop() {
+
+    int status = 0;
+
+    ::close(this->fd);
+    while (waitpid(this->pid, &status, 0) < 0 && errno == EINTR);
+
+    this->fd = -1;
+    this->pid = -1;
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+}
+
+bool GnuplotSession::writeAll(const char *buf, size_t n) {
+
+    while (n > 0) {
+        ssize_t w = send(this->fd, buf, n, MSG_NOSIGNAL);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buf += w;
+        n -= w;
+    }
+    return true;
+
+}
+
+bool GnuplotSession::waitMarker(const string &marker) {
+
+    char buf[4096];
+    size_t start = 0;
+
+    while (true) {
+        // consume complete lines, forwarding to stdout everything that is not the marker
+        size_t end;
+        while ((end = this->readBuffer.find('\n', start)) != string::npos) {
+            if (this->readBuffer.compare(start, end - start, marker) == 0) {
+                this->readBuffer.erase(0, end + 1);
+                return true;
+            }
+            cout.write(this->readBuffer.data() + start, end - start + 1);
+            start = end + 1;
+        }
+        this->readBuffer.erase(0, start);
+        start = 0;
+
+        ssize_t r = read(this->fd, buf, sizeof(buf));
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        this->readBuffer.append(buf, r);
+    }
+
+}
+
+bool GnuplotSession::running() {
+
+    if (this->pid <= 0) return false;
+
+    int status;
+    if (waitpid(this->pid, &status, WNOHANG) == this->pid) {
+        // gnuplot is gone, reaped here: just release our end of the socket
+        ::close(this->fd);
+        this->fd = -1;
+        this->pid = -1;
+        return false;
+    }
+    return true;
+
+}
+
+bool GnuplotSession::isAlive() {
+
+    lock_guard<mutex> guard(this->lock);
+    return running();
+
+}
+
+void GnuplotSession::restart() {
+
+    lock_guard<mutex> guard(this->lock);
+
+    if (running()) {
+        kill(this->pid, SIGTERM);
+        stop();
+    }
+    start();
+
+}
+
+int GnuplotSession::run(const string &script) {
+
+    return execute(script, true);
+
+}
+
+int GnuplotSession::update(const string &script) {
+
+    return execute(script, false);
+
+}
+
+int GnuplotSession::execute(const string &script, const bool &reset) {
+
+    lock_guard<mutex> guard(this->lock);
+
+    if (!running()) start();
+
+    const string marker = "simplePlot_done_" + to_string(++this->nScripts);
+    const string header = reset ? "reset\n" : "";
+    const string footer = "\nset print \"-\"\nprint \"" + marker + "\"\nset print\n";
+
+    if (writeAll(header.c_str(), header.size()) &&
+        writeAll(script.c_str(), script.size()) &&
+        writeAll(footer.c_str(), footer.size()) &&
+        waitMarker(marker))
+        return 0;
+
+    int status = stop();
+    cout << "[WARNING] gnuplot session died (exit status " << status << "), "
+            "it will be restarted on next plot." << endl;
+    return (status != 0) ? status : -1;
+
+}
+
+unsigned long GnuplotSession::startCount() {
+
+    lock_guard<mutex> guard(this->lock);
+    return this->nStarts;
+
+}
+
+shared_ptr<GnuplotSession> GnuplotSession::processSession() {
+
+    static shared_ptr<GnuplotSession> session = make_shared<GnuplotSession>();
+    return session;
+
+}
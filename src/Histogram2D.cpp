@@ -0,0 +1,241 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "Histogram2D.h"
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+
+// below this many points per thread, starting a thread costs more than it saves
+static const size_t minPointsPerThread = 1 << 16;
+
+static size_t threadsFor(const size_t& n, const size_t& threads) {
+
+    size_t nThreads = (threads > 0) ? threads : thread::hardware_concurrency();
+    if (nThreads == 0) nThreads = 1;
+
+    return std::max<size_t>(1, std::min(nThreads, n / minPointsPerThread));
+
+}
+
+// runs work(t, first, last) on nThreads threads, thread t taking the t-th slice of [0, n)
+template<typename Work>
+static void forEachSlice(const size_t& n, const size_t& nThreads, const Work& work) {
+
+    if (nThreads == 1) {
+        work(0, 0, n);
+        return;
+    }
+
+    vector<thread> workers;
+    for (size_t t = 1; t < nThreads; ++t) workers.push_back(thread(work, t, t * n / nThreads, (t + 1) * n / nThreads));
+    work(0, 0, n / nThreads);
+    for (size_t t = 0; t < workers.size(); ++t) workers[t].join();
+
+}
+
+/**
+ * bins n points of contiguous x, y. The axis types are template arguments, so the loop has no branch on them.
+ * @return number of points binned
+ */
+template<bool logX, bool logY>
+static uint64_t binPoints(const double* x, const double* y, const size_t& n,
+                          const double& x0, const double& xScale, const size_t& nx,
+                          const double& y0, const double& yScale, const size_t& ny, uint64_t* counts) {
+
+    const double xLimit = (double) nx;
+    const double yLimit = (double) ny;
+    uint64_t binned = 0;
+
+    for (size_t k = 0; k < n; ++k) {
+        const double u = ((logX ? log10(x[k]) : x[k]) - x0) * xScale;
+        const double v = ((logY ? log10(y[k]) : y[k]) - y0) * yScale;
+        // nan (not finite, or not positive on a log axis) fails both comparisons
+        if (!(u >= 0 && u <= xLimit) || !(v >= 0 && v <= yLimit)) continue;
+
+        // points on the upper edge go in the last bin
+        const size_t i = std::min((size_t) u, nx - 1);
+        const size_t j = std::min((size_t) v, ny - 1);
+        ++counts[j * nx + i];
+        ++binned;
+    }
+
+    return binned;
+
+}
+
+Histogram2D::Histogram2D(const size_t &xBins, const size_t &yBins,
+                         const double &xMin, const double &xMax, const double &yMin, const double &yMax,
+                         const bool &logX, const bool &logY) {
+
+    if (xBins == 0 || yBins == 0) {
+        cout<<"\n\n[ERROR] a 2D histogram needs at least one bin per axis.\n\n"<<endl;
+        throw std::runtime_error("Histogram2D::Histogram2D(const size_t &xBins, const size_t &yBins, const double &xMin, const double &xMax, const double &yMin, const double &yMax, const bool &logX, const bool &logY)");
+    }
+    if (!(xMin < xMax) || !(yMin < yMax) || !std::isfinite(xMax - xMin) || !std::isfinite(yMax - yMin) ||
+        (logX && xMin <= 0) || (logY && yMin <= 0)) {
+        cout<<"\n\n[ERROR] wrong 2D histogram bounds: they must be finite, min < max, and positive on a log axis.\n\n"<<endl;
+        throw std::runtime_error("Histogram2D::Histogram2D(const size_t &xBins, const size_t &yBins, const double &xMin, const double &xMax, const double &yMin, const double &yMax, const bool &logX, const bool &logY)");
+    }
+
+    this->nx = xBins;
+    this->ny = yBins;
+    this->xMin = xMin;
+    this->xMax = xMax;
+    this->yMin = yMin;
+    this->yMax = yMax;
+    this->logX = logX;
+    this->logY = logY;
+    this->x0 = logX ? log10(xMin) : xMin;
+    this->y0 = logY ? log10(yMin) : yMin;
+    this->xScale = xBins / ((logX ? log10(xMax) : xMax) - this->x0);
+    this->yScale = yBins / ((logY ? log10(yMax) : yMax) - this->y0);
+    this->counts.assign(xBins * yBins, 0);
+    this->binned = 0;
+    this->dropped = 0;
+
+}
+
+uint64_t Histogram2D::binRange(const DataView &x, const DataView &y, const size_t &first, const size_t &last,
+                               uint64_t *counts) const {
+
+    auto bin = (this->logX ? (this->logY ? binPoints<true, true> : binPoints<true, false>)
+                           : (this->logY ? binPoints<false, true> : binPoints<false, false>));
+
+    // contiguous doubles are binned in place, other views a chunk at a time
+    const size_t chunk = DataView::chunkSize;
+    double bufferX[DataView::chunkSize], bufferY[DataView::chunkSize];
+    uint64_t binned = 0;
+
+    if (x.doubles() && y.doubles()) {
+        return bin(x.doubles() + first, y.doubles() + first, last - first,
+                   this->x0, this->xScale, this->nx, this->y0, this->yScale, this->ny, counts);
+    }
+
+    for (size_t start = first; start < last; start += chunk) {
+        const size_t count = std::min(chunk, last - start);
+        binned += bin(x.read(start, count, bufferX), y.read(start, count, bufferY), count,
+                      this->x0, this->xScale, this->nx, this->y0, this->yScale, this->ny, counts);
+    }
+
+    return binned;
+
+}
+
+void Histogram2D::add(const DataView &x, const DataView &y, const size_t &threads) {
+
+    if (x.size() != y.size()) {
+        cout<<"\n\n[ERROR] x and y must have same dimension.\n\n"<<endl;
+        throw std::runtime_error("void Histogram2D::add(const DataView &x, const DataView &y, const size_t &threads)");
+    }
+
+    const size_t n = x.size();
+    const size_t nThreads = threadsFor(n, threads);
+    const size_t nBins = this->counts.size();
+
+    uint64_t binned = 0;
+
+    if (nThreads == 1) {
+        binned = binRange(x, y, 0, n, this->counts.data());
+    } else {
+        // one set of counts per thread, so that threads never write the same memory
+        vector<vector<uint64_t>> partial(nThreads);
+        vector<uint64_t> partialBinned(nThreads, 0);
+        forEachSlice(n, nThreads, [&](const size_t t, const size_t first, const size_t last) {
+            partial[t].assign(nBins, 0);
+            partialBinned[t] = binRange(x, y, first, last, partial[t].data());
+        });
+
+        // counts are summed in parallel too, each thread a slice of the bins
+        forEachSlice(nBins, std::min(nThreads, std::max<size_t>(1, nBins / 4096)),
+                     [&](const size_t, const size_t first, const size_t last) {
+            for (size_t t = 0; t < nThreads; ++t) {
+                const uint64_t* from = partial[t].data();
+                for (size_t b = first; b < last; ++b) this->counts[b] += from[b];
+            }
+        });
+
+        for (size_t t = 0; t < nThreads; ++t) binned += partialBinned[t];
+    }
+
+    this->binned += binned;
+    this->dropped += n - binned;
+
+}
+
+uint64_t Histogram2D::maxCount() const {
+
+    return this->counts.empty() ? 0 : *std::max_element(this->counts.begin(), this->counts.end());
+
+}
+
+double Histogram2D::xEdge(const size_t &i) const {
+
+    if (i >= this->nx) return this->xMax;
+    const double v = this->x0 + i / this->xScale;
+    return this->logX ? pow(10.0, v) : v;
+
+}
+
+double Histogram2D::yEdge(const size_t &j) const {
+
+    if (j >= this->ny) return this->yMax;
+    const double v = this->y0 + j / this->yScale;
+    return this->logY ? pow(10.0, v) : v;
+
+}
+
+double Histogram2D::xCenter(const size_t &i) const {
+
+    const double v = this->x0 + (i + 0.5) / this->xScale;
+    return this->logX ? pow(10.0, v) : v;
+
+}
+
+double Histogram2D::yCenter(const size_t &j) const {
+
+    const double v = this->y0 + (j + 0.5) / this->yScale;
+    return this->logY ? pow(10.0, v) : v;
+
+}
+
+ValueRange parallelValueRange(const DataView &values, const bool &positiveOnly, const size_t &threads) {
+
+    const size_t n = values.size();
+    const size_t nThreads = threadsFor(n, threads);
+
+    if (nThreads == 1) return valueRange(values, positiveOnly);
+
+    vector<ValueRange> partial(nThreads);
+    forEachSlice(n, nThreads, [&](const size_t t, const size_t first, const size_t last) {
+        if (values.doubles()) {
+            partial[t] = valueRange(values.doubles() + first, last - first, positiveOnly);
+            return;
+        }
+        double buffer[DataView::chunkSize];
+        for (size_t start = first; start < last; start += DataView::chunkSize) {
+            const size_t count = std::min(DataView::chunkSize, last - start);
+            partial[t].merge(valueRange(values.read(start, count, buffer), count, positiveOnly));
+        }
+    });
+
+    ValueRange range;
+    for (size_t t = 0; t < nThreads; ++t) range.merge(partial[t]);
+
+    return range;
+
+}
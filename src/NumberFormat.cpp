@@ -0,0 +1,393 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "NumberFormat.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+// ------------------------------------------------------------------------ shortest digits (Grisu2)
+// Digits of a double, read back as the same double, are generated with 64 bit integers only
+// (F. Loitsch, "Printing floating-point numbers quickly and accurately with integers", PLDI 2010).
+// The output is the shortest one but for very few values, where one more digit is written.
+
+// floating point number f * 2^e
+struct DiyFp {
+    uint64_t f;
+    int e;
+};
+
+static DiyFp diyMultiply(const DiyFp& x, const DiyFp& y) {
+
+    // upper 64 bits of the 128 bit product, rounded
+    const uint64_t xLo = x.f & 0xFFFFFFFFu, xHi = x.f >> 32;
+    const uint64_t yLo = y.f & 0xFFFFFFFFu, yHi = y.f >> 32;
+    const uint64_t p0 = xLo * yLo, p1 = xLo * yHi, p2 = xHi * yLo, p3 = xHi * yHi;
+    uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    q += uint64_t(1) << 31;
+
+    DiyFp r;
+    r.f = p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+
+}
+
+static DiyFp diyNormalize(DiyFp x) {
+
+    while ((x.f >> 63) == 0) {
+        x.f <<= 1;
+        --x.e;
+    }
+    return x;
+
+}
+
+// 10^k as f * 2^e, k = -300, -292, ..., 324
+struct CachedPower {
+    uint64_t f;
+    int e;
+    int k;
+};
+
+static const CachedPower cachedPowers[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060,  -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034,  -292 },
+    { 0xBE5691EF416BD60CULL, -1007,  -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980,  -276 },
+    { 0xD3515C2831559A83ULL,  -954,  -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927,  -260 },
+    { 0xEA9C227723EE8BCBULL,  -901,  -252 },
+    { 0xAECC49914078536DULL,  -874,  -244 },
+    { 0x823C12795DB6CE57ULL,  -847,  -236 },
+    { 0xC21094364DFB5637ULL,  -821,  -228 },
+    { 0x9096EA6F3848984FULL,  -794,  -220 },
+    { 0xD77485CB25823AC7ULL,  -768,  -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741,  -204 },
+    { 0xEF340A98172AACE5ULL,  -715,  -196 },
+    { 0xB23867FB2A35B28EULL,  -688,  -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661,  -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635,  -172 },
+    { 0x936B9FCEBB25C996ULL,  -608,  -164 },
+    { 0xDBAC6C247D62A584ULL,  -582,  -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555,  -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529,  -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502,  -132 },
+    { 0x87625F056C7C4A8BULL,  -475,  -124 },
+    { 0xC9BCFF6034C13053ULL,  -449,  -116 },
+    { 0x964E858C91BA2655ULL,  -422,  -108 },
+    { 0xDFF9772470297EBDULL,  -396,  -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,   -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,   -84 },
+    { 0xB94470938FA89BCFULL,  -316,   -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,   -68 },
+    { 0xCDB02555653131B6ULL,  -263,   -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,   -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,   -44 },
+    { 0xAA242499697392D3ULL,  -183,   -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,   -28 },
+    { 0xBCE5086492111AEBULL,  -130,   -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,   -12 },
+    { 0xD1B71758E219652CULL,   -77,    -4 },
+    { 0x9C40000000000000ULL,   -50,     4 },
+    { 0xE8D4A51000000000ULL,   -24,    12 },
+    { 0xAD78EBC5AC620000ULL,     3,    20 },
+    { 0x813F3978F8940984ULL,    30,    28 },
+    { 0xC097CE7BC90715B3ULL,    56,    36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,    44 },
+    { 0xD5D238A4ABE98068ULL,   109,    52 },
+    { 0x9F4F2726179A2245ULL,   136,    60 },
+    { 0xED63A231D4C4FB27ULL,   162,    68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,    76 },
+    { 0x83C7088E1AAB65DBULL,   216,    84 },
+    { 0xC45D1DF942711D9AULL,   242,    92 },
+    { 0x924D692CA61BE758ULL,   269,   100 },
+    { 0xDA01EE641A708DEAULL,   295,   108 },
+    { 0xA26DA3999AEF774AULL,   322,   116 },
+    { 0xF209787BB47D6B85ULL,   348,   124 },
+    { 0xB454E4A179DD1877ULL,   375,   132 },
+    { 0x865B86925B9BC5C2ULL,   402,   140 },
+    { 0xC83553C5C8965D3DULL,   428,   148 },
+    { 0x952AB45CFA97A0B3ULL,   455,   156 },
+    { 0xDE469FBD99A05FE3ULL,   481,   164 },
+    { 0xA59BC234DB398C25ULL,   508,   172 },
+    { 0xF6C69A72A3989F5CULL,   534,   180 },
+    { 0xB7DCBF5354E9BECEULL,   561,   188 },
+    { 0x88FCF317F22241E2ULL,   588,   196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,   204 },
+    { 0x98165AF37B2153DFULL,   641,   212 },
+    { 0xE2A0B5DC971F303AULL,   667,   220 },
+    { 0xA8D9D1535CE3B396ULL,   694,   228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,   236 },
+    { 0xBB764C4CA7A44410ULL,   747,   244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,   252 },
+    { 0xD01FEF10A657842CULL,   800,   260 },
+    { 0x9B10A4E5E9913129ULL,   827,   268 },
+    { 0xE7109BFBA19C0C9DULL,   853,   276 },
+    { 0xAC2820D9623BF429ULL,   880,   284 },
+    { 0x80444B5E7AA7CF85ULL,   907,   292 },
+    { 0xBF21E44003ACDD2DULL,   933,   300 },
+    { 0x8E679C2F5E44FF8FULL,   960,   308 },
+    { 0xD433179D9C8CB841ULL,   986,   316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,   324 },
+};
+
+// digits are generated with the scaled value exponent in [alpha, gamma]
+static const int grisuAlpha = -60;
+
+static CachedPower cachedPowerFor(const int& e) {
+
+    // smallest k with alpha <= e + e_c + 64, e_c being the binary exponent of 10^-k
+    const int f = grisuAlpha - e - 1;
+    const int k = (f * 78913) / (1 << 18) + (f > 0);
+    const int index = (300 + k + 7) / 8;
+    return cachedPowers[index];
+
+}
+
+static int largestPow10(const uint32_t& n, uint32_t& pow10) {
+
+    static const uint32_t powers[] = {1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u};
+    int digits = 10;
+    while (digits > 1 && n < powers[digits - 1]) --digits;
+    pow10 = powers[digits - 1];
+    return digits;
+
+}
+
+// moves the last digit towards the value while it stays in the interval
+static void grisuRound(char* digits, const int& length, const uint64_t& dist, const uint64_t& delta,
+                       uint64_t rest, const uint64_t& tenK) {
+
+    while (rest < dist && delta - rest >= tenK && (rest + tenK < dist || dist - rest > rest + tenK - dist)) {
+        --digits[length - 1];
+        rest += tenK;
+    }
+
+}
+
+// writes the digits of value (finite, > 0), value is digits * 10^exponent
+static int grisuDigits(const double& value, char* digits, int& exponent) {
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(double));
+    const uint64_t hidden = uint64_t(1) << 52;
+    const uint64_t fraction = bits & (hidden - 1);
+    const int biased = (int) (bits >> 52);
+
+    DiyFp v;
+    v.f = (biased == 0) ? fraction : fraction + hidden;
+    v.e = (biased == 0) ? 1 - 1075 : biased - 1075;
+
+    // boundaries of the values rounded to v: halfway to the previous and to the next double
+    const bool closerBelow = (fraction == 0 && biased > 1);
+    DiyFp plus, minus;
+    plus.f = 2 * v.f + 1;
+    plus.e = v.e - 1;
+    minus.f = closerBelow ? 4 * v.f - 1 : 2 * v.f - 1;
+    minus.e = closerBelow ? v.e - 2 : v.e - 1;
+
+    plus = diyNormalize(plus);
+    minus.f <<= (minus.e - plus.e);
+    minus.e = plus.e;
+    v = diyNormalize(v);
+
+    const CachedPower cached = cachedPowerFor(plus.e);
+    DiyFp c;
+    c.f = cached.f;
+    c.e = cached.e;
+
+    const DiyFp w = diyMultiply(v, c);
+    DiyFp high = diyMultiply(plus, c);
+    DiyFp low = diyMultiply(minus, c);
+    // products may be off by one: the interval is narrowed to stay inside the exact one
+    ++low.f;
+    --high.f;
+
+    exponent = -cached.k;
+
+    uint64_t delta = high.f - low.f;
+    uint64_t dist = high.f - w.f;
+
+    const int shift = -high.e;
+    const uint64_t one = uint64_t(1) << shift;
+    uint32_t p1 = (uint32_t) (high.f >> shift);
+    uint64_t p2 = high.f & (one - 1);
+
+    int length = 0;
+
+    // integral part
+    uint32_t pow10;
+    int n = largestPow10(p1, pow10);
+    while (n > 0) {
+        digits[length++] = (char) ('0' + p1 / pow10);
+        p1 %= pow10;
+        --n;
+
+        const uint64_t rest = ((uint64_t) p1 << shift) + p2;
+        if (rest <= delta) {
+            exponent += n;
+            grisuRound(digits, length, dist, delta, rest, (uint64_t) pow10 << shift);
+            return length;
+        }
+        pow10 /= 10;
+    }
+
+    // fractional part
+    int m = 0;
+    for (;;) {
+        p2 *= 10;
+        digits[length++] = (char) ('0' + (p2 >> shift));
+        p2 &= one - 1;
+        ++m;
+
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta) break;
+    }
+    exponent -= m;
+    grisuRound(digits, length, dist, delta, p2, one);
+
+    return length;
+
+}
+
+// writes digits * 10^exponent as gnuplot (and printf "%g") would: fixed notation if the point
+// is close to the digits, scientific notation otherwise
+static size_t placePoint(char* buffer, const char* digits, const int& length, const int& exponent) {
+
+    // position of the decimal point, relative to the first digit
+    const int point = length + exponent;
+    size_t n = 0;
+
+    if (length <= point && point <= 15) {
+        // 1234e2 -> 123400
+        memcpy(buffer, digits, length);
+        n = length;
+        for (int k = length; k < point; ++k) buffer[n++] = '0';
+    } else if (0 < point && point <= 15) {
+        // 1234e-2 -> 12.34
+        memcpy(buffer, digits, point);
+        buffer[point] = '.';
+        memcpy(buffer + point + 1, digits + point, length - point);
+        n = length + 1;
+    } else if (-4 < point && point <= 0) {
+        // 1234e-6 -> 0.001234
+        buffer[n++] = '0';
+        buffer[n++] = '.';
+        for (int k = point; k < 0; ++k) buffer[n++] = '0';
+        memcpy(buffer + n, digits, length);
+        n += length;
+    } else {
+        // 1234e20 -> 1.234e+23
+        buffer[n++] = digits[0];
+        if (length > 1) {
+            buffer[n++] = '.';
+            memcpy(buffer + n, digits + 1, length - 1);
+            n += length - 1;
+        }
+        int e = point - 1;
+        buffer[n++] = 'e';
+        buffer[n++] = (e < 0) ? '-' : '+';
+        if (e < 0) e = -e;
+        if (e >= 100) buffer[n++] = (char) ('0' + e / 100);
+        buffer[n++] = (char) ('0' + (e / 10) % 10);
+        buffer[n++] = (char) ('0' + e % 10);
+    }
+
+    return n;
+
+}
+
+// ------------------------------------------------------------------------ formatting
+
+// integers up to 1e15 are written digit by digit: exact and much faster than printf
+static size_t formatInteger(char* buffer, const double& value) {
+
+    char digits[24];
+    size_t nDigits = 0;
+    unsigned long long u = (unsigned long long) fabs(value);
+
+    do {
+        digits[nDigits++] = (char) ('0' + u % 10);
+        u /= 10;
+    } while (u > 0);
+
+    size_t n = 0;
+    if (signbit(value)) buffer[n++] = '-';
+    while (nDigits > 0) buffer[n++] = digits[--nDigits];
+
+    return n;
+
+}
+
+static size_t printDigits(char* buffer, const double& value, const int& digits) {
+
+    int n = snprintf(buffer, maxNumberLength, "%.*g", digits, value);
+    if (n < 0) n = 0;
+    if ((size_t) n >= maxNumberLength) n = maxNumberLength - 1;
+
+    return (size_t) n;
+
+}
+
+// printf and strtod honour the C locale: the decimal separator may not be '.'
+static void fixSeparator(char* buffer, const size_t& n) {
+
+    for (size_t k = 0; k < n; ++k) {
+        const char c = buffer[k];
+        if (c != '-' && c != '+' && c != 'e' && (c < '0' || c > '9')) buffer[k] = '.';
+    }
+
+}
+
+size_t formatDouble(char* buffer, const double& value, const int& precision) {
+
+    if (!std::isfinite(value)) {
+        const char* text = std::isnan(value) ? "nan" : (value > 0 ? "inf" : "-inf");
+        const size_t n = strlen(text);
+        memcpy(buffer, text, n);
+        return n;
+    }
+
+    const int digits = (precision > 17) ? 17 : ((precision < 0) ? 0 : precision);
+
+    if ((digits == 0 || digits >= 15) && fabs(value) < 1e15 && value == floor(value)) return formatInteger(buffer, value);
+
+    if (digits > 0) {
+        const size_t n = printDigits(buffer, value, digits);
+        fixSeparator(buffer, n);
+        return n;
+    }
+
+    // shortest round trip
+    char text[24];
+    int exponent;
+    const int length = grisuDigits(fabs(value), text, exponent);
+
+    size_t n = 0;
+    if (signbit(value)) buffer[n++] = '-';
+
+    return n + placePoint(buffer + n, text, length, exponent);
+
+}
+
+string formatNumber(const double& value, const int& precision) {
+
+    char buffer[maxNumberLength];
+    return string(buffer, formatDouble(buffer, value, precision));
+
+}
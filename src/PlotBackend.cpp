@@ -0,0 +1,46 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "PlotBackend.h"
+#include "GnuplotDriver.h"
+
+bool GnuplotBackend::canRender(const PlotScene &/*scene*/) const {
+
+    return true;
+
+}
+
+int GnuplotBackend::render(const PlotScene &scene, const string &fileName) {
+
+    gnuplot_axis_type axis = gnuplot_axis_type::GNUPLOT_LINEAR;
+    if (scene.logX && scene.logY) axis = gnuplot_axis_type::GNUPLOT_LOGLOG;
+    else if (scene.logX) axis = gnuplot_axis_type::GNUPLOT_XLOG;
+    else if (scene.logY) axis = gnuplot_axis_type::GNUPLOT_YLOG;
+
+    GnuplotDriver driver(axis, gnuplot_action_type::GNUPLOT_SAVE, fileName, gnuplot_save_type::GNUPLOT_PNG);
+    driver.setSaveSize(scene.width, scene.height);
+    driver.setPlotOptions(scene.plotOptions);
+
+    if (!scene.title.empty()) driver.setTitle(scene.title);
+    if (scene.titleFont > 0) driver.setTitleFont(scene.titleFont);
+    if (!scene.xLabel.empty()) driver.setXLabel(scene.xLabel, scene.xLabelFont > 0 ? scene.xLabelFont : 20);
+    if (!scene.yLabel.empty()) driver.setYLabel(scene.yLabel, scene.yLabelFont > 0 ? scene.yLabelFont : 20);
+    if (scene.xRangeSet) driver.setXRange(scene.xMin, scene.xMax);
+    if (scene.yRangeSet) driver.setYRange(scene.yMin, scene.yMax);
+    if (!scene.noLegend) driver.setLegendTitles(scene.titles);
+
+    return driver.plotSeries(scene.x, scene.y);
+
+}
@@ -0,0 +1,580 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "PlotServer.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+const char* const serverDataSource = "@SP_SERVER_DATA@";
+
+// requests and replies are read by processes of the same host: fields are in host byte order
+static const char requestMagic[4] = {'S', 'P', 'J', '1'};
+static const char replyMagic[4] = {'S', 'P', 'R', '1'};
+static const uint32_t jobRequest = 1;
+static const uint32_t statsRequest = 2;
+
+struct RequestHeader {
+    char magic[4];
+    uint32_t kind;
+    uint64_t cwdSize, scriptSize, dataSize;
+};
+
+struct ReplyHeader {
+    char magic[4];
+    int32_t status;
+    uint64_t payloadSize;
+};
+
+// last jobs kept for latency percentiles
+static const size_t latencySamples = 4096;
+
+// largest parts of a request or reply: a client sending more is dropped
+static const uint64_t maxCwdSize = PATH_MAX;
+static const uint64_t maxScriptSize = uint64_t(1) << 28;
+static const uint64_t maxDataSize = uint64_t(1) << 34;
+static const uint64_t maxPayloadSize = uint64_t(1) << 20;
+
+static bool sendAll(const int& fd, const char* buf, size_t n) {
+
+    while (n > 0) {
+        const ssize_t w = send(fd, buf, n, MSG_NOSIGNAL);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buf += w;
+        n -= w;
+    }
+    return true;
+
+}
+
+static bool recvAll(const int& fd, char* buf, size_t n) {
+
+    while (n > 0) {
+        const ssize_t r = recv(fd, buf, n, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        buf += r;
+        n -= r;
+    }
+    return true;
+
+}
+
+static bool recvString(const int& fd, const uint64_t& size, const uint64_t& maxSize, string& s) {
+
+    if (size > maxSize) return false;
+    s.resize(size);
+    return size == 0 || recvAll(fd, &s[0], size);
+
+}
+
+static bool socketAddress(const string& path, sockaddr_un& address) {
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+
+}
+
+// true if the process at the other end of fd is run by our user
+static bool sameUser(const int& fd) {
+
+    ucred peer;
+    socklen_t size = sizeof(peer);
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &size) == 0 && peer.uid == getuid();
+
+}
+
+static double percentile(vector<double> samples, const double& p) {
+
+    if (samples.empty()) return 0;
+    const size_t k = std::min(samples.size() - 1, (size_t) (p * samples.size()));
+    nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+
+}
+
+string defaultServerSocket() {
+
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && *runtimeDir) return string(runtimeDir) + "/simplePlot.sock";
+
+    return "/tmp/simplePlot-" + to_string(getuid()) + ".sock";
+
+}
+
+string ServerStats::toText() const {
+
+    ostringstream out;
+    out << "workers " << this->workers << "\n"
+        << "connections " << this->connections << "\n"
+        << "queueDepth " << this->queueDepth << "\n"
+        << "maxQueueDepth " << this->maxQueueDepth << "\n"
+        << "jobs " << this->jobs << "\n"
+        << "failed " << this->failed << "\n"
+        << "dataBytes " << this->dataBytes << "\n"
+        << "waitMs50 " << this->waitMs50 << "\n"
+        << "waitMs99 " << this->waitMs99 << "\n"
+        << "latencyMs50 " << this->latencyMs50 << "\n"
+        << "latencyMs90 " << this->latencyMs90 << "\n"
+        << "latencyMs99 " << this->latencyMs99 << "\n";
+
+    return out.str();
+
+}
+
+ServerStats ServerStats::fromText(const string &text) {
+
+    ServerStats stats;
+    istringstream in(text);
+    string name;
+    double value;
+
+    while (in >> name >> value) {
+        if (name == "workers") stats.workers = (size_t) value;
+        else if (name == "connections") stats.connections = (size_t) value;
+        else if (name == "queueDepth") stats.queueDepth = (size_t) value;
+        else if (name == "maxQueueDepth") stats.maxQueueDepth = (size_t) value;
+        else if (name == "jobs") stats.jobs = (uint64_t) value;
+        else if (name == "failed") stats.failed = (uint64_t) value;
+        else if (name == "dataBytes") stats.dataBytes = (uint64_t) value;
+        else if (name == "waitMs50") stats.waitMs50 = value;
+        else if (name == "waitMs99") stats.waitMs99 = value;
+        else if (name == "latencyMs50") stats.latencyMs50 = value;
+        else if (name == "latencyMs90") stats.latencyMs90 = value;
+        else if (name == "latencyMs99") stats.latencyMs99 = value;
+    }
+
+    return stats;
+
+}
+
+PlotServer::PlotServer(const string &socket, const size_t &workers, const size_t &maxDepth, const size_t &batch) {
+
+    sockaddr_un address;
+    if (!socketAddress(socket, address)) {
+        cout<<"\n\n[ERROR] socket name " << socket << " is too long.\n\n"<<endl;
+        throw std::runtime_error("PlotServer::PlotServer(const string &socket, const size_t &workers, const size_t &maxDepth, const size_t &batch)");
+    }
+
+    this->listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (this->listenFd < 0) {
+        cout<<"\n\n[ERROR] could not create socket.\n\n"<<endl;
+        throw std::runtime_error("PlotServer::PlotServer(const string &socket, const size_t &workers, const size_t &maxDepth, const size_t &batch)");
+    }
+
+    // a socket nobody answers on is left by a server that did not exit cleanly: it is replaced
+    if (connect(this->listenFd, (const sockaddr*) &address, sizeof(address)) == 0) {
+        ::close(this->listenFd);
+        cout<<"\n\n[ERROR] a server is already listening on " << socket << ".\n\n"<<endl;
+        throw std::runtime_error("PlotServer::PlotServer(const string &socket, const size_t &workers, const size_t &maxDepth, const size_t &batch)");
+    }
+    unlink(socket.c_str());
+
+    // jobs name files to be written: only our user can connect, from the moment the socket exists
+    const mode_t previousMask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
+    const bool bound = (bind(this->listenFd, (const sockaddr*) &address, sizeof(address)) == 0);
+    umask(previousMask);
+    if (!bound || listen(this->listenFd, 128) != 0) {
+        ::close(this->listenFd);
+        cout<<"\n\n[ERROR] could not listen on " << socket << ".\n\n"<<endl;
+        throw std::runtime_error("PlotServer::PlotServer(const string &socket, const size_t &workers, const size_t &maxDepth, const size_t &batch)");
+    }
+
+    if (pipe2(this->wakePipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+        ::close(this->listenFd);
+        unlink(socket.c_str());
+        cout<<"\n\n[ERROR] could not create pipe.\n\n"<<endl;
+        throw std::runtime_error("PlotServer::PlotServer(const string &socket, const size_t &workers, const size_t &maxDepth, const size_t &batch)");
+    }
+
+    this->socketPath = socket;
+    this->nWorkers = (workers > 0) ? workers : thread::hardware_concurrency();
+    if (this->nWorkers == 0) this->nWorkers = 1;
+    this->maxDepth = std::max<size_t>(maxDepth, 1);
+    this->batchSize = std::max<size_t>(batch, 1);
+    this->stopping = false;
+    this->activeClients = 0;
+    this->maxQueueDepth = 0;
+    this->nJobs = 0;
+    this->nFailed = 0;
+    this->nDataBytes = 0;
+    this->nextSample = 0;
+
+    for (size_t w = 0; w < this->nWorkers; ++w) this->workers.push_back(thread(&PlotServer::work, this));
+
+}
+
+PlotServer::~PlotServer() {
+
+    // no new client, then the connected ones are closed once their jobs are done
+    ::close(this->listenFd);
+    unlink(this->socketPath.c_str());
+
+    {
+        unique_lock<mutex> guard(this->lock);
+        for (set<int>::const_iterator fd = this->clients.begin(); fd != this->clients.end(); ++fd) shutdown(*fd, SHUT_RD);
+        this->clientsDone.wait(guard, [this]() { return this->activeClients == 0; });
+        this->stopping = true;
+    }
+    this->notEmpty.notify_all();
+    this->notFull.notify_all();
+    for (size_t w = 0; w < this->workers.size(); ++w) this->workers[w].join();
+
+    ::close(this->wakePipe[0]);
+    ::close(this->wakePipe[1]);
+
+}
+
+void PlotServer::run() {
+
+    pollfd fds[2];
+    fds[0].fd = this->listenFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = this->wakePipe[0];
+    fds[1].events = POLLIN;
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        const int fd = accept4(this->listenFd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        if (!sameUser(fd)) {
+            ::close(fd);
+            continue;
+        }
+
+        {
+            lock_guard<mutex> guard(this->lock);
+            this->clients.insert(fd);
+            ++this->activeClients;
+        }
+        thread(&PlotServer::serve, this, fd).detach();
+    }
+
+    // the wake up byte is consumed, so run can be called again
+    char c;
+    while (read(this->wakePipe[0], &c, 1) > 0);
+
+}
+
+void PlotServer::stop() {
+
+    const char c = 1;
+    if (write(this->wakePipe[1], &c, 1) < 0) return;
+
+}
+
+void PlotServer::serve(int fd) {
+
+    // anything going wrong with a client (i.e. no memory for its data) closes its connection only
+    try {
+        serveRequests(fd);
+    } catch (std::exception&) {
+        cout << "[WARNING] dropped a simplePlot-server client after an error." << endl;
+    }
+
+    lock_guard<mutex> guard(this->lock);
+    this->clients.erase(fd);
+    ::close(fd);
+    --this->activeClients;
+    this->clientsDone.notify_all();
+
+}
+
+void PlotServer::serveRequests(const int &fd) {
+
+    while (true) {
+        RequestHeader header;
+        if (!recvAll(fd, (char*) &header, sizeof(header)) || memcmp(header.magic, requestMagic, 4) != 0) break;
+
+        unique_ptr<Job> job(new Job());
+        if (!recvString(fd, header.cwdSize, maxCwdSize, job->cwd) ||
+            !recvString(fd, header.scriptSize, maxScriptSize, job->script) ||
+            !recvString(fd, header.dataSize, maxDataSize, job->data)) break;
+        job->received = chrono::steady_clock::now();
+
+        ReplyHeader reply;
+        memcpy(reply.magic, replyMagic, 4);
+        string payload;
+        if (header.kind == jobRequest) {
+            reply.status = submit(move(job));
+        } else if (header.kind == statsRequest) {
+            payload = stats().toText();
+            reply.status = 0;
+        } else {
+            reply.status = -1;
+        }
+        reply.payloadSize = payload.size();
+
+        if (!sendAll(fd, (const char*) &reply, sizeof(reply)) || !sendAll(fd, payload.data(), payload.size())) break;
+    }
+
+}
+
+int PlotServer::submit(unique_ptr<Job> job) {
+
+    future<int> status = job->status.get_future();
+
+    {
+        unique_lock<mutex> guard(this->lock);
+        this->notFull.wait(guard, [this]() { return this->jobs.size() < this->maxDepth || this->stopping; });
+        if (this->stopping) return -1;
+        this->nDataBytes += job->data.size();
+        this->jobs.push_back(move(job));
+        this->maxQueueDepth = std::max(this->maxQueueDepth, this->jobs.size());
+    }
+    this->notEmpty.notify_one();
+
+    return status.get();
+
+}
+
+void PlotServer::work() {
+
+    GnuplotSession session(false);
+
+    // plot data of the jobs of this worker: a memory file, or a file if memory files are not available
+    int dataFd;
+    string dataName;
+#ifdef MFD_CLOEXEC
+    dataFd = memfd_create("simplePlot_server_data", MFD_CLOEXEC);
+    dataName = "\"/proc/" + to_string(getpid()) + "/fd/" + to_string(dataFd) + "\"";
+#else
+    const char* tmpDir = getenv("TMPDIR");
+    string fileName = string((tmpDir && *tmpDir) ? tmpDir : "/tmp") + "/simplePlot_server_XXXXXX";
+    dataFd = mkostemp(&fileName[0], O_CLOEXEC);
+    dataName = "\"" + fileName + "\"";
+#endif
+
+    while (true) {
+        vector<unique_ptr<Job>> batch;
+        {
+            unique_lock<mutex> guard(this->lock);
+            this->notEmpty.wait(guard, [this]() { return !this->jobs.empty() || this->stopping; });
+            if (this->jobs.empty()) break;
+
+            // a share of the queue, so that other workers get jobs too
+            const size_t share = (this->jobs.size() + this->nWorkers - 1) / this->nWorkers;
+            const size_t n = std::min(this->batchSize, share);
+            for (size_t k = 0; k < n; ++k) {
+                batch.push_back(move(this->jobs.front()));
+                this->jobs.pop_front();
+            }
+        }
+        this->notFull.notify_all();
+
+        for (size_t k = 0; k < batch.size(); ++k) {
+            Job& job = *batch[k];
+            const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+            int status;
+            try {
+                status = (dataFd >= 0) ? runJob(job, session, dataFd, dataName) : -1;
+            } catch (std::exception&) {
+                status = -1;
+            }
+
+            const chrono::steady_clock::time_point end = chrono::steady_clock::now();
+            {
+                lock_guard<mutex> guard(this->lock);
+                ++this->nJobs;
+                if (status != 0) ++this->nFailed;
+                if (this->waits.size() < latencySamples) {
+                    this->waits.push_back(0);
+                    this->latencies.push_back(0);
+                }
+                const size_t s = this->nextSample++ % latencySamples;
+                this->waits[s] = chrono::duration<double, milli>(start - job.received).count();
+                this->latencies[s] = chrono::duration<double, milli>(end - job.received).count();
+            }
+            job.status.set_value(status);
+        }
+    }
+
+    if (dataFd >= 0) ::close(dataFd);
+#ifndef MFD_CLOEXEC
+    unlink(fileName.c_str());
+#endif
+
+}
+
+int PlotServer::runJob(Job &job, GnuplotSession &session, const int &dataFd, const string &dataName) {
+
+    string script;
+    if (!job.cwd.empty()) {
+        // single quoted gnuplot strings have no escapes, but quotes written twice
+        string cwd;
+        for (size_t k = 0; k < job.cwd.size(); ++k) cwd += (job.cwd[k] == '\'') ? "''" : string(1, job.cwd[k]);
+        script = "cd '" + cwd + "'\n";
+    }
+
+    const string placeholder = serverDataSource;
+    size_t from = 0, pos;
+    while ((pos = job.script.find(placeholder, from)) != string::npos) {
+        script.append(job.script, from, pos - from);
+        script += dataName;
+        from = pos + placeholder.size();
+    }
+    script.append(job.script, from, string::npos);
+
+    // emptied even without data: a job must never read the data of the previous one
+    if (ftruncate(dataFd, 0) != 0) return -1;
+    size_t written = 0;
+    while (written < job.data.size()) {
+        const ssize_t w = pwrite(dataFd, job.data.data() + written, job.data.size() - written, written);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        written += w;
+    }
+
+    return session.run(script);
+
+}
+
+ServerStats PlotServer::stats() {
+
+    lock_guard<mutex> guard(this->lock);
+
+    ServerStats stats;
+    stats.workers = this->nWorkers;
+    stats.connections = this->clients.size();
+    stats.queueDepth = this->jobs.size();
+    stats.maxQueueDepth = this->maxQueueDepth;
+    stats.jobs = this->nJobs;
+    stats.failed = this->nFailed;
+    stats.dataBytes = this->nDataBytes;
+    stats.waitMs50 = percentile(this->waits, 0.5);
+    stats.waitMs99 = percentile(this->waits, 0.99);
+    stats.latencyMs50 = percentile(this->latencies, 0.5);
+    stats.latencyMs90 = percentile(this->latencies, 0.9);
+    stats.latencyMs99 = percentile(this->latencies, 0.99);
+
+    return stats;
+
+}
+
+PlotClient::PlotClient(const string &socket) {
+
+    this->socketPath = socket;
+    this->fd = -1;
+
+}
+
+PlotClient::~PlotClient() {
+
+    if (this->fd >= 0) ::close(this->fd);
+
+}
+
+void PlotClient::connectServer() {
+
+    sockaddr_un address;
+    if (!socketAddress(this->socketPath, address)) {
+        cout<<"\n\n[ERROR] socket name " << this->socketPath << " is too long.\n\n"<<endl;
+        throw std::runtime_error("void PlotClient::connectServer()");
+    }
+
+    this->fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (this->fd >= 0 && connect(this->fd, (const sockaddr*) &address, sizeof(address)) == 0) {
+        // a socket in /tmp may have been bound by another user first: scripts and data are not sent there
+        if (sameUser(this->fd)) return;
+        ::close(this->fd);
+        this->fd = -1;
+        cout<<"\n\n[ERROR] the server on " << this->socketPath << " is run by another user.\n\n"<<endl;
+        throw std::runtime_error("void PlotClient::connectServer()");
+    }
+
+    if (this->fd >= 0) ::close(this->fd);
+    this->fd = -1;
+    cout<<"\n\n[ERROR] could not connect to simplePlot-server on " << this->socketPath << ", is it running?\n\n"<<endl;
+    throw std::runtime_error("void PlotClient::connectServer()");
+
+}
+
+int PlotClient::request(const uint32_t &kind, const string &script, const string &data, string &payload) {
+
+    char path[PATH_MAX];
+    const string cwd = getcwd(path, sizeof(path)) ? path : "";
+
+    RequestHeader header;
+    memcpy(header.magic, requestMagic, 4);
+    header.kind = kind;
+    header.cwdSize = cwd.size();
+    header.scriptSize = script.size();
+    header.dataSize = data.size();
+
+    lock_guard<mutex> guard(this->lock);
+
+    // a connection opened before the server was restarted fails once: it is opened again
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (this->fd < 0) connectServer();
+
+        ReplyHeader reply;
+        if (sendAll(this->fd, (const char*) &header, sizeof(header)) &&
+            sendAll(this->fd, cwd.data(), cwd.size()) &&
+            sendAll(this->fd, script.data(), script.size()) &&
+            sendAll(this->fd, data.data(), data.size()) &&
+            recvAll(this->fd, (char*) &reply, sizeof(reply)) &&
+            memcmp(reply.magic, replyMagic, 4) == 0 &&
+            recvString(this->fd, reply.payloadSize, maxPayloadSize, payload))
+            return reply.status;
+
+        ::close(this->fd);
+        this->fd = -1;
+    }
+
+    cout<<"\n\n[ERROR] lost connection to simplePlot-server on " << this->socketPath << ".\n\n"<<endl;
+    throw std::runtime_error("int PlotClient::request(const uint32_t &kind, const string &script, const string &data, string &payload)");
+
+}
+
+int PlotClient::run(const string &script, const string &data) {
+
+    string payload;
+    return request(jobRequest, script, data, payload);
+
+}
+
+ServerStats PlotClient::stats() {
+
+    string payload;
+    request(statsRequest, "", "", payload);
+
+    return ServerStats::fromText(payload);
+
+}
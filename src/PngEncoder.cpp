@@ -0,0 +1,306 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "PngEncoder.h"
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// deflate (RFC 1951) constants: base value and extra bits of length codes 257..285 and distance codes 0..29
+static const unsigned short lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                              35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const unsigned char lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                              3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const unsigned short distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                                8193, 12289, 16385, 24577};
+static const unsigned char distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static const size_t windowSize = 32768;
+static const size_t maxMatch = 258;
+static const size_t hashBits = 15;
+
+// fixed Huffman codes of literals and lengths, bit reversed (deflate sends them from the most significant bit)
+struct FixedCodes {
+
+    unsigned short code[288];
+    unsigned char bits[288];
+    unsigned short distance[30];
+
+    static unsigned short reverse(unsigned short c, const int& n) {
+        unsigned short r = 0;
+        for (int i = 0; i < n; ++i, c >>= 1) r = (r << 1) | (c & 1);
+        return r;
+    }
+
+    FixedCodes() {
+        for (int v = 0; v < 288; ++v) {
+            if (v < 144)      { code[v] = reverse(0x30 + v, 8);          bits[v] = 8; }
+            else if (v < 256) { code[v] = reverse(0x190 + (v - 144), 9); bits[v] = 9; }
+            else if (v < 280) { code[v] = reverse(v - 256, 7);           bits[v] = 7; }
+            else              { code[v] = reverse(0xC0 + (v - 280), 8);  bits[v] = 8; }
+        }
+        for (int d = 0; d < 30; ++d) distance[d] = reverse(d, 5);
+    }
+
+};
+
+// deflate bit stream, least significant bit first
+class BitWriter {
+
+private:
+
+    string& out;
+    uint64_t buffer;
+    int count;
+
+public:
+    explicit BitWriter(string& out) : out(out), buffer(0), count(0) {}
+
+    void put(const uint32_t& value, const int& bits) {
+        this->buffer |= (uint64_t) value << this->count;
+        this->count += bits;
+        while (this->count >= 8) {
+            this->out += (char) (this->buffer & 0xFF);
+            this->buffer >>= 8;
+            this->count -= 8;
+        }
+    }
+
+    void flush() {
+        if (this->count > 0) this->out += (char) (this->buffer & 0xFF);
+        this->buffer = 0;
+        this->count = 0;
+    }
+
+};
+
+// compresses data as one deflate block with fixed Huffman codes
+static void deflateFixed(const unsigned char* data, const size_t& n, string& out) {
+
+    static const FixedCodes codes;
+
+    BitWriter bits(out);
+    bits.put(1, 1);     // last block
+    bits.put(1, 2);     // fixed Huffman codes
+
+    // last position + 1 of every hash of 3 bytes, 0 if none
+    vector<uint32_t> head(size_t(1) << hashBits, 0);
+    auto hash = [&](const size_t& i) {
+        const uint32_t v = data[i] | (data[i+1] << 8) | (data[i+2] << 16);
+        return (v * 2654435761u) >> (32 - hashBits);
+    };
+    auto matchLength = [&](const size_t& i, const size_t& candidate, const size_t& limit) {
+        // 8 bytes at a time, then byte by byte from the 8 that differ
+        size_t length = 0;
+        while (length + 8 <= limit) {
+            uint64_t a, b;
+            memcpy(&a, data + candidate + length, 8);
+            memcpy(&b, data + i + length, 8);
+            if (a != b) break;
+            length += 8;
+        }
+        while (length < limit && data[candidate + length] == data[i + length]) ++length;
+        return length;
+    };
+
+    size_t i = 0;
+    while (i < n) {
+        size_t best = 0;
+        size_t distance = 0;
+
+        if (i + 3 <= n) {
+            const size_t limit = std::min(maxMatch, n - i);
+            // runs of a byte (flat areas, filtered to zeros) are the common case: try them first
+            if (i > 0) {
+                best = matchLength(i, i - 1, limit);
+                distance = 1;
+            }
+            const uint32_t h = hash(i);
+            const size_t candidate = head[h];
+            head[h] = (uint32_t) (i + 1);
+            if (best < limit && candidate > 0 && i - (candidate - 1) <= windowSize && candidate - 1 != i - 1) {
+                const size_t length = matchLength(i, candidate - 1, limit);
+                if (length > best) {
+                    best = length;
+                    distance = i - (candidate - 1);
+                }
+            }
+        }
+
+        if (best < 3) {
+            bits.put(codes.code[data[i]], codes.bits[data[i]]);
+            ++i;
+            continue;
+        }
+
+        int l = 28;
+        while (lengthBase[l] > best) --l;
+        bits.put(codes.code[257 + l], codes.bits[257 + l]);
+        if (lengthExtra[l] > 0) bits.put((uint32_t) (best - lengthBase[l]), lengthExtra[l]);
+
+        int d = 29;
+        while (distanceBase[d] > distance) --d;
+        bits.put(codes.distance[d], 5);
+        if (distanceExtra[d] > 0) bits.put((uint32_t) (distance - distanceBase[d]), distanceExtra[d]);
+
+        // short matches are indexed, long ones (runs) are skipped to keep the encoder fast
+        const size_t end = i + best;
+        if (best < 32) {
+            for (size_t k = i + 1; k < end && k + 3 <= n; ++k) head[hash(k)] = (uint32_t) (k + 1);
+        }
+        i = end;
+    }
+
+    bits.put(codes.code[256], codes.bits[256]);
+    bits.flush();
+
+}
+
+static uint32_t crc32(const unsigned char* p, const size_t& n, uint32_t crc = 0) {
+
+    static uint32_t table[256];
+    static bool ready = [](uint32_t* t) {
+        for (uint32_t k = 0; k < 256; ++k) {
+            uint32_t c = k;
+            for (int b = 0; b < 8; ++b) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[k] = c;
+        }
+        return true;
+    }(table);
+    (void) ready;
+
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+
+}
+
+static uint32_t adler32(const unsigned char* p, const size_t& n) {
+
+    uint32_t a = 1, b = 0;
+    size_t i = 0;
+    while (i < n) {
+        // largest block whose sums cannot overflow before the modulo
+        const size_t end = std::min(n, i + 5552);
+        // 16 bytes at a time: their sum and their sum weighted by distance from the end, no chain between bytes
+        for (; i + 16 <= end; i += 16) {
+            uint32_t sum = 0, weighted = 0;
+            for (int k = 0; k < 16; ++k) {
+                sum += p[i + k];
+                weighted += (16 - k) * p[i + k];
+            }
+            b += 16 * a + weighted;
+            a += sum;
+        }
+        for (; i < end; ++i) {
+            a += p[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+
+}
+
+static void putBigEndian(string& out, const uint32_t& v) {
+
+    out += (char) (v >> 24);
+    out += (char) (v >> 16);
+    out += (char) (v >> 8);
+    out += (char) v;
+
+}
+
+static void putChunk(string& out, const char* type, const string& data) {
+
+    putBigEndian(out, (uint32_t) data.size());
+    const size_t start = out.size();
+    out.append(type, 4);
+    out += data;
+    putBigEndian(out, crc32(reinterpret_cast<const unsigned char*>(out.data()) + start, out.size() - start));
+
+}
+
+string encodePng(const unsigned char *rgba, const size_t &width, const size_t &height) {
+
+    // opaque images (i.e. plots) are written without alpha: a quarter less to compress
+    bool opaque = true;
+    for (size_t k = 3; k < 4 * width * height && opaque; k += 4) opaque = (rgba[k] == 255);
+    const size_t channels = opaque ? 3 : 4;
+
+    // filtered rows: sub for the first one, up for the others (both zero on flat areas)
+    const size_t rowBytes = channels * width;
+    vector<unsigned char> filtered((rowBytes + 1) * height);
+    for (size_t r = 0; r < height; ++r) {
+        const unsigned char* row = rgba + 4 * r * width;
+        unsigned char* f = filtered.data() + r * (rowBytes + 1);
+        f[0] = (r == 0) ? 1 : 2;
+        ++f;
+
+        if (r == 0) {
+            for (size_t k = 0; k < width; ++k, row += 4, f += channels) {
+                for (size_t c = 0; c < channels; ++c) f[c] = (unsigned char) (row[c] - (k > 0 ? row[c-4] : 0));
+            }
+        } else if (opaque) {
+            const unsigned char* above = row - 4 * width;
+            for (size_t k = 0; k < width; ++k, row += 4, above += 4, f += 3) {
+                f[0] = (unsigned char) (row[0] - above[0]);
+                f[1] = (unsigned char) (row[1] - above[1]);
+                f[2] = (unsigned char) (row[2] - above[2]);
+            }
+        } else {
+            const unsigned char* above = row - 4 * width;
+            for (size_t k = 0; k < rowBytes; ++k) f[k] = (unsigned char) (row[k] - above[k]);
+        }
+    }
+
+    string idat;
+    idat += (char) 0x78;    // zlib header: deflate, 32K window
+    idat += (char) 0x01;
+    deflateFixed(filtered.data(), filtered.size(), idat);
+    putBigEndian(idat, adler32(filtered.data(), filtered.size()));
+
+    string header;
+    putBigEndian(header, (uint32_t) width);
+    putBigEndian(header, (uint32_t) height);
+    header += (char) 8;                 // bits per channel
+    header += (char) (opaque ? 2 : 6);  // rgb or rgba
+    header += string(3, '\0');          // deflate, adaptive filters, no interlace
+
+    string png("\x89PNG\r\n\x1a\n", 8);
+    putChunk(png, "IHDR", header);
+    putChunk(png, "IDAT", idat);
+    putChunk(png, "IEND", "");
+
+    return png;
+
+}
+
+bool writePng(const string &fileName, const unsigned char *rgba, const size_t &width, const size_t &height) {
+
+    const string png = encodePng(rgba, width, height);
+
+    ofstream out(fileName, ios::binary | ios::trunc);
+    if (!out) return false;
+    out.write(png.data(), png.size());
+
+    return (bool) out;
+
+}
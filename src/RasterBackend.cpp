@@ -0,0 +1,334 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "RasterBackend.h"
+#include "DataKernels.h"
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+// default colors of gnuplot line types 1 to 8
+static const uint32_t lineColors[8] = {0x9400D3, 0x009E73, 0x56B4E9, 0xE69F00, 0xF0E442, 0x0072B2, 0xE51E10, 0x000000};
+
+static const uint32_t black = 0x000000;
+static const int pad = 8;           // pixels around the plot and between its parts
+static const int tickLength = 6;
+
+// reads gnuplot plot options: "with lines", "w p", "w lp"... Anything else cannot be drawn
+static bool plotStyle(const string& options, bool& lines, bool& points) {
+
+    istringstream in(options);
+    vector<string> tokens;
+    string token;
+    while (in >> token) tokens.push_back(token);
+
+    lines = true;
+    points = false;
+    if (tokens.empty()) return true;
+    if (tokens.size() != 2 || string("with").compare(0, tokens[0].size(), tokens[0]) != 0) return false;
+
+    const string& style = tokens[1];
+    if (style == "l" || style == "lines") return true;
+    lines = false;
+    points = true;
+    if (style == "p" || style == "points") return true;
+    lines = true;
+    return style == "lp" || style == "linespoints";
+
+}
+
+// font size (gnuplot points) to scale of the 5x7 font
+static int fontScale(const int& size, const int& defaultScale) {
+
+    return (size > 0) ? std::max(1, (int) lround(size / 10.0)) : defaultScale;
+
+}
+
+// range, ticks and tick labels of an axis
+struct Axis {
+
+    double min = 0, max = 1;
+    bool log = false;
+    vector<double> ticks;
+    vector<string> labels;
+
+    // position of v along the axis, 0 at min and 1 at max
+    double unit(const double& v) const {
+        return this->log ? (log10(v) - log10(this->min)) / (log10(this->max) - log10(this->min))
+                         : (v - this->min) / (this->max - this->min);
+    }
+
+    int labelWidth() const {
+        int width = 0;
+        for (size_t k = 0; k < this->labels.size(); ++k) width = std::max(width, Framebuffer::textWidth(this->labels[k]));
+        return width;
+    }
+
+};
+
+static string tickLabel(const double& v) {
+
+    char label[32];
+    snprintf(label, sizeof(label), "%g", v);
+    return label;
+
+}
+
+// 1, 2 or 5 times a power of 10, close to span / target
+static double niceStep(const double& span, const int& target) {
+
+    const double raw = span / std::max(1, target);
+    const double magnitude = pow(10, floor(log10(raw)));
+    const double f = raw / magnitude;
+    return magnitude * ((f < 1.5) ? 1 : (f < 3) ? 2 : (f < 7) ? 5 : 10);
+
+}
+
+// ticks of axis for about target ticks, extending the range to the outer ticks if extend
+static void placeTicks(Axis& axis, const int& target, const bool& extend) {
+
+    axis.ticks.clear();
+    axis.labels.clear();
+
+    if (axis.log) {
+        double lo = log10(axis.min), hi = log10(axis.max);
+        if (extend) {
+            lo = floor(lo + 1e-9);
+            hi = ceil(hi - 1e-9);
+            if (lo == hi) {
+                lo -= 1;
+                hi += 1;
+            }
+            axis.min = pow(10, lo);
+            axis.max = pow(10, hi);
+        }
+        const long long first = (long long) ceil(lo - 1e-9), last = (long long) floor(hi + 1e-9);
+        const long long every = std::max(1LL, (long long) ceil((last - first + 1) / (double) std::max(1, target)));
+        for (long long k = first; k <= last; k += every) {
+            axis.ticks.push_back(pow(10, (double) k));
+            axis.labels.push_back(tickLabel(axis.ticks.back()));
+        }
+        return;
+    }
+
+    const double step = niceStep(axis.max - axis.min, target);
+    if (extend) {
+        axis.min = floor(axis.min / step + 1e-9) * step;
+        axis.max = ceil(axis.max / step - 1e-9) * step;
+    }
+    const long long first = (long long) ceil(axis.min / step - 1e-9), last = (long long) floor(axis.max / step + 1e-9);
+    for (long long k = first; k <= last; ++k) {
+        // multiples of step, so that labels do not show rounding errors
+        const double v = (k == 0) ? 0 : k * step;
+        axis.ticks.push_back(v);
+        axis.labels.push_back(tickLabel(v));
+    }
+
+}
+
+// range of the values of views (or the one set), made valid: min < max, positive on log axes
+static Axis makeAxis(const vector<DataView>& views, const bool& log, const bool& set, const double& setMin, const double& setMax) {
+
+    Axis axis;
+    axis.log = log;
+
+    if (set) {
+        axis.min = setMin;
+        axis.max = setMax;
+    } else {
+        ValueRange range;
+        for (size_t i = 0; i < views.size(); ++i) range.merge(valueRange(views[i], log));
+        if (range.count > 0) {
+            axis.min = range.min;
+            axis.max = range.max;
+        } else {
+            // nothing to plot: gnuplot default ranges
+            axis.min = log ? 1 : -10;
+            axis.max = log ? 10 : 10;
+        }
+    }
+
+    if (axis.min > axis.max) swap(axis.min, axis.max);
+    if (axis.min == axis.max) {
+        // single value: a small range around it
+        if (log) {
+            axis.min /= 1.1;
+            axis.max *= 1.1;
+        } else {
+            const double margin = (axis.min != 0) ? 0.01 * fabs(axis.min) : 1;
+            axis.min -= margin;
+            axis.max += margin;
+        }
+    }
+
+    return axis;
+
+}
+
+bool RasterBackend::canRender(const PlotScene &scene) const {
+
+    bool lines, points;
+    if (!plotStyle(scene.plotOptions, lines, points)) return false;
+    if (scene.width < 64 || scene.height < 64 || scene.width > 16384 || scene.height > 16384) return false;
+    if (scene.x.size() != scene.y.size()) return false;
+
+    // ranges gnuplot would refuse are left to it, for its error messages
+    if (scene.logX && scene.xRangeSet && (scene.xMin <= 0 || scene.xMax <= 0)) return false;
+    if (scene.logY && scene.yRangeSet && (scene.yMin <= 0 || scene.yMax <= 0)) return false;
+
+    return true;
+
+}
+
+int RasterBackend::render(const PlotScene &scene, const string &fileName) {
+
+    const Framebuffer image = rasterize(scene);
+
+    if (!image.savePng(fileName)) {
+        cout << "[WARNING] could not write " << fileName << endl;
+        return 1;
+    }
+
+    return 0;
+
+}
+
+Framebuffer RasterBackend::rasterize(const PlotScene &scene) const {
+
+    const int width = (int) scene.width, height = (int) scene.height;
+    Framebuffer image(scene.width, scene.height);
+
+    bool lines, points;
+    plotStyle(scene.plotOptions, lines, points);
+
+    const int titleScale = fontScale(scene.titleFont, 2);
+    const int xLabelScale = fontScale(scene.xLabelFont, 1);
+    const int yLabelScale = fontScale(scene.yLabelFont, 1);
+    const int tickHeight = Framebuffer::textHeight();
+
+    // vertical layout first: y ticks depend on the height of the plot only
+    const int top = pad + tickHeight / 2 + (scene.title.empty() ? 0 : Framebuffer::textHeight(titleScale) + pad);
+    const int bottom = height - 1 - pad - tickHeight - tickLength
+                       - (scene.xLabel.empty() ? 0 : Framebuffer::textHeight(xLabelScale) + pad);
+
+    Axis yAxis = makeAxis(scene.y, scene.logY, scene.yRangeSet, scene.yMin, scene.yMax);
+    placeTicks(yAxis, std::max(2, (bottom - top) / 40), !scene.yRangeSet);
+
+    const int left = pad + yAxis.labelWidth() + tickLength
+                     + (scene.yLabel.empty() ? 0 : Framebuffer::textHeight(yLabelScale) + pad);
+    const int right = width - 1 - 2 * pad;
+
+    // fewer x ticks until their labels do not overlap
+    const Axis xRange = makeAxis(scene.x, scene.logX, scene.xRangeSet, scene.xMin, scene.xMax);
+    Axis xAxis;
+    for (int target = std::max(2, (right - left) / 60); ; --target) {
+        xAxis = xRange;
+        placeTicks(xAxis, target, !scene.xRangeSet);
+        const int spacing = (xAxis.ticks.size() > 1) ? (right - left) / ((int) xAxis.ticks.size() - 1) : right - left;
+        if (target <= 2 || xAxis.labelWidth() + pad <= spacing) break;
+    }
+
+    auto px = [&](const double& v) { return left + xAxis.unit(v) * (right - left); };
+    auto py = [&](const double& v) { return bottom - yAxis.unit(v) * (bottom - top); };
+
+    // series, clipped to the plot area
+    image.setClip(left, top, right, bottom);
+    const size_t chunk = DataView::chunkSize;
+    double bufferX[DataView::chunkSize], bufferY[DataView::chunkSize];
+    for (size_t i = 0; i < scene.x.size(); ++i) {
+        const uint32_t color = lineColors[i % 8];
+        const size_t n = std::min(scene.x[i].size(), scene.y[i].size());
+        bool connected = false;
+        double lastX = 0, lastY = 0;
+        for (size_t start = 0; start < n; start += chunk) {
+            const size_t count = std::min(chunk, n - start);
+            const double* x = scene.x[i].read(start, count, bufferX);
+            const double* y = scene.y[i].read(start, count, bufferY);
+            for (size_t k = 0; k < count; ++k) {
+                // points that cannot be plotted break the line, as in gnuplot
+                if (!std::isfinite(x[k]) || !std::isfinite(y[k]) || (scene.logX && x[k] <= 0) || (scene.logY && y[k] <= 0)) {
+                    connected = false;
+                    continue;
+                }
+                const double cx = px(x[k]), cy = py(y[k]);
+                if (lines && connected) image.drawLine(lastX, lastY, cx, cy, color);
+                if (points) {
+                    image.drawLine(cx - 3, cy, cx + 3, cy, color);
+                    image.drawLine(cx, cy - 3, cx, cy + 3, color);
+                }
+                lastX = cx;
+                lastY = cy;
+                connected = true;
+            }
+        }
+    }
+    image.setClip(0, 0, width - 1, height - 1);
+
+    // border and ticks, inside the plot on all sides
+    image.fillRect(left, top, right, top, black);
+    image.fillRect(left, bottom, right, bottom, black);
+    image.fillRect(left, top, left, bottom, black);
+    image.fillRect(right, top, right, bottom, black);
+
+    for (size_t k = 0; k < xAxis.ticks.size(); ++k) {
+        const int x = (int) lround(px(xAxis.ticks[k]));
+        image.fillRect(x, bottom - tickLength, x, bottom, black);
+        image.fillRect(x, top, x, top + tickLength, black);
+        const int labelWidth = Framebuffer::textWidth(xAxis.labels[k]);
+        image.drawText(x - labelWidth / 2, bottom + tickLength, xAxis.labels[k], black);
+    }
+    for (size_t k = 0; k < yAxis.ticks.size(); ++k) {
+        const int y = (int) lround(py(yAxis.ticks[k]));
+        image.fillRect(left, y, left + tickLength, y, black);
+        image.fillRect(right - tickLength, y, right, y, black);
+        const int labelWidth = Framebuffer::textWidth(yAxis.labels[k]);
+        image.drawText(left - tickLength - labelWidth, y - tickHeight / 2, yAxis.labels[k], black);
+    }
+
+    // title and axis labels, centered on the plot
+    const int centerX = (left + right) / 2, centerY = (top + bottom) / 2;
+    if (!scene.title.empty())
+        image.drawText(centerX - Framebuffer::textWidth(scene.title, titleScale) / 2, pad, scene.title, black, titleScale);
+    if (!scene.xLabel.empty())
+        image.drawText(centerX - Framebuffer::textWidth(scene.xLabel, xLabelScale) / 2, bottom + tickLength + tickHeight + pad,
+                       scene.xLabel, black, xLabelScale);
+    if (!scene.yLabel.empty())
+        image.drawText(pad, centerY + Framebuffer::textWidth(scene.yLabel, yLabelScale) / 2, scene.yLabel, black, yLabelScale, true);
+
+    // legend: title right aligned, then a sample of the line, in the top right corner
+    if (!scene.noLegend) {
+        const int sampleEnd = right - 2 * pad;
+        const int sampleStart = sampleEnd - 4 * pad;
+        int entry = 0;
+        for (size_t i = 0; i < scene.x.size() && i < scene.titles.size(); ++i) {
+            if (scene.titles[i].empty()) continue;
+            const int y = top + pad + entry * (tickHeight + 5);
+            image.drawText(sampleStart - pad - Framebuffer::textWidth(scene.titles[i]), y, scene.titles[i], black);
+            const double lineY = y + tickHeight / 2;
+            if (lines) image.drawLine(sampleStart, lineY, sampleEnd, lineY, lineColors[i % 8]);
+            if (points) {
+                const double markX = (sampleStart + sampleEnd) / 2;
+                image.drawLine(markX - 3, lineY, markX + 3, lineY, lineColors[i % 8]);
+                image.drawLine(markX, lineY - 3, markX, lineY + 3, lineColors[i % 8]);
+            }
+            ++entry;
+        }
+    }
+
+    return image;
+
+}
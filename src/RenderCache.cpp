@@ -0,0 +1,393 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "RenderCache.h"
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+// ------------------------------------------------------------------------ XXH64
+
+static const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t prime3 = 0x165667B19E3779F9ULL;
+static const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotateLeft(const uint64_t& x, const int& r) {
+
+    return (x << r) | (x >> (64 - r));
+
+}
+
+// little-endian reads, whatever the host is
+static inline uint64_t read64(const unsigned char* p) {
+
+    uint64_t v = 0;
+    for (int k = 7; k >= 0; --k) v = (v << 8) | p[k];
+    return v;
+
+}
+
+static inline uint64_t read32(const unsigned char* p) {
+
+    return (uint64_t) p[0] | ((uint64_t) p[1] << 8) | ((uint64_t) p[2] << 16) | ((uint64_t) p[3] << 24);
+
+}
+
+static inline uint64_t hashRound(uint64_t acc, const uint64_t& input) {
+
+    acc += input * prime2;
+    acc = rotateLeft(acc, 31);
+    return acc * prime1;
+
+}
+
+static inline uint64_t mergeRound(uint64_t acc, const uint64_t& v) {
+
+    acc ^= hashRound(0, v);
+    return acc * prime1 + prime4;
+
+}
+
+Hasher64::Hasher64(const uint64_t &seed) {
+
+    reset(seed);
+
+}
+
+void Hasher64::reset(const uint64_t &seed) {
+
+    this->seed = seed;
+    this->v[0] = seed + prime1 + prime2;
+    this->v[1] = seed + prime2;
+    this->v[2] = seed;
+    this->v[3] = seed - prime1;
+    this->nPending = 0;
+    this->total = 0;
+
+}
+
+void Hasher64::stripe(const unsigned char *p) {
+
+    for (int k = 0; k < 4; ++k) this->v[k] = hashRound(this->v[k], read64(p + 8 * k));
+
+}
+
+void Hasher64::update(const void *data, const size_t &length) {
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    size_t n = length;
+    this->total += length;
+
+    if (this->nPending > 0) {
+        const size_t fill = min(n, 32 - this->nPending);
+        memcpy(this->pending + this->nPending, p, fill);
+        this->nPending += fill;
+        p += fill;
+        n -= fill;
+        if (this->nPending < 32) return;
+        stripe(this->pending);
+        this->nPending = 0;
+    }
+
+    while (n >= 32) {
+        stripe(p);
+        p += 32;
+        n -= 32;
+    }
+
+    memcpy(this->pending, p, n);
+    this->nPending = n;
+
+}
+
+uint64_t Hasher64::digest() const {
+
+    uint64_t h;
+    if (this->total >= 32) {
+        h = rotateLeft(this->v[0], 1) + rotateLeft(this->v[1], 7) + rotateLeft(this->v[2], 12) + rotateLeft(this->v[3], 18);
+        for (int k = 0; k < 4; ++k) h = mergeRound(h, this->v[k]);
+    } else {
+        h = this->seed + prime5;
+    }
+    h += this->total;
+
+    const unsigned char* p = this->pending;
+    size_t n = this->nPending;
+    while (n >= 8) {
+        h ^= hashRound(0, read64(p));
+        h = rotateLeft(h, 27) * prime1 + prime4;
+        p += 8;
+        n -= 8;
+    }
+    if (n >= 4) {
+        h ^= read32(p) * prime1;
+        h = rotateLeft(h, 23) * prime2 + prime3;
+        p += 4;
+        n -= 4;
+    }
+    while (n > 0) {
+        h ^= (*p) * prime5;
+        h = rotateLeft(h, 11) * prime1;
+        ++p;
+        --n;
+    }
+
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+
+    return h;
+
+}
+
+// ------------------------------------------------------------------------ HashingStreamBuffer
+
+HashingStreamBuffer::int_type HashingStreamBuffer::overflow(int_type c) {
+
+    if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+
+    const char ch = traits_type::to_char_type(c);
+    this->hasher.update(&ch, 1);
+    return this->target->sputc(ch);
+
+}
+
+streamsize HashingStreamBuffer::xsputn(const char *s, streamsize n) {
+
+    this->hasher.update(s, (size_t) n);
+    return this->target->sputn(s, n);
+
+}
+
+int HashingStreamBuffer::sync() {
+
+    return this->target->pubsync();
+
+}
+
+// ------------------------------------------------------------------------ RenderCache
+
+static bool copyFile(const string& from, const string& to) {
+
+    const int in = open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) return false;
+    const int out = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        close(in);
+        return false;
+    }
+
+    vector<char> buffer(1 << 20);
+    bool ok = true;
+    ssize_t r;
+    while (ok && (r = read(in, buffer.data(), buffer.size())) != 0) {
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+        const char* p = buffer.data();
+        while (r > 0) {
+            const ssize_t w = write(out, p, r);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                ok = false;
+                break;
+            }
+            p += w;
+            r -= w;
+        }
+    }
+
+    close(in);
+    if (close(out) != 0) ok = false;
+    if (!ok) unlink(to.c_str());
+
+    return ok;
+
+}
+
+// puts a copy of from in to. to is removed first, so that a file linked to it is never written
+static bool replaceWithCopy(const string& from, const string& to) {
+
+    unlink(to.c_str());
+    return copyFile(from, to);
+
+}
+
+RenderCache::RenderCache(const string &directory, const size_t &maxBytes, const gnuplot_cache_policy &policy) {
+
+    this->directory = directory;
+    this->maxBytes = maxBytes;
+    this->policy = policy;
+
+    // creates every missing directory of the path
+    size_t pos = 0;
+    do {
+        pos = directory.find('/', pos + 1);
+        const string partial = directory.substr(0, pos);
+        if (mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST) {
+            cout<<"\n\n[ERROR] could not create cache directory " << partial << ".\n\n"<<endl;
+            throw std::runtime_error("RenderCache::RenderCache(const string &directory, const size_t &maxBytes, const gnuplot_cache_policy &policy)");
+        }
+    } while (pos != string::npos);
+
+    lock_guard<mutex> guard(this->lock);
+    evict();
+
+}
+
+string RenderCache::entryName(const uint64_t &key, const string &extension) const {
+
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+    return this->directory + "/" + name + extension;
+
+}
+
+// extension of fileName, with its dot. Empty if none
+static string extensionOf(const string& fileName) {
+
+    const size_t dot = fileName.rfind('.');
+    const size_t slash = fileName.rfind('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) return "";
+    return fileName.substr(dot);
+
+}
+
+bool RenderCache::fetch(const uint64_t &key, const string &fileName) {
+
+    lock_guard<mutex> guard(this->lock);
+
+    const string entry = entryName(key, extensionOf(fileName));
+    struct stat info;
+    if (stat(entry.c_str(), &info) != 0 || !replaceWithCopy(entry, fileName)) {
+        ++this->counters.misses;
+        return false;
+    }
+
+    // the modification time orders entries for eviction. The entry is a file of its own, not the output
+    if (this->policy == gnuplot_cache_policy::GNUPLOT_LRU) utimes(entry.c_str(), NULL);
+
+    ++this->counters.hits;
+    return true;
+
+}
+
+void RenderCache::store(const uint64_t &key, const string &fileName) {
+
+    lock_guard<mutex> guard(this->lock);
+
+    struct stat info;
+    if (stat(fileName.c_str(), &info) != 0) return;
+
+    // the entry appears at once: other processes never read half of it
+    string tmp = this->directory + "/.tmp_XXXXXX";
+    const int fd = mkstemp(&tmp[0]);
+    if (fd < 0) return;
+    close(fd);
+
+    // an entry the same key already had (i.e. stored by another process) is replaced, not added
+    const string entry = entryName(key, extensionOf(fileName));
+    struct stat previous;
+    const size_t replaced = (stat(entry.c_str(), &previous) == 0) ? (size_t) previous.st_size : 0;
+    if (!copyFile(fileName, tmp) || rename(tmp.c_str(), entry.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return;
+    }
+
+    ++this->counters.stores;
+    this->counters.bytes += info.st_size;
+    this->counters.bytes -= min(replaced, this->counters.bytes);
+    if (this->counters.bytes > this->maxBytes) evict();
+
+}
+
+void RenderCache::evict() {
+
+    // the directory is scanned, so entries written by other processes are counted too
+    struct Entry {
+        string name;
+        time_t time;
+        size_t size;
+    };
+    vector<Entry> entries;
+    size_t bytes = 0;
+
+    DIR* dir = opendir(this->directory.c_str());
+    if (!dir) return;
+    struct dirent* e;
+    while ((e = readdir(dir)) != NULL) {
+        if (e->d_name[0] == '.') continue;
+        const string name = this->directory + "/" + e->d_name;
+        struct stat info;
+        if (stat(name.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) continue;
+        entries.push_back({name, info.st_mtime, (size_t) info.st_size});
+        bytes += info.st_size;
+    }
+    closedir(dir);
+
+    sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+
+    for (size_t k = 0; k < entries.size() && bytes > this->maxBytes; ++k) {
+        if (unlink(entries[k].name.c_str()) != 0) continue;
+        bytes -= entries[k].size;
+        ++this->counters.evictions;
+    }
+
+    this->counters.bytes = bytes;
+
+}
+
+void RenderCache::setMaxBytes(const size_t &bytes) {
+
+    lock_guard<mutex> guard(this->lock);
+    this->maxBytes = bytes;
+    evict();
+
+}
+
+void RenderCache::clear() {
+
+    lock_guard<mutex> guard(this->lock);
+    const size_t limit = this->maxBytes;
+    const size_t evictions = this->counters.evictions;
+    this->maxBytes = 0;
+    evict();
+    this->maxBytes = limit;
+    this->counters.evictions = evictions;
+
+}
+
+RenderCacheStats RenderCache::stats() {
+
+    lock_guard<mutex> guard(this->lock);
+    return this->counters;
+
+}
@@ -0,0 +1,94 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "RenderQueue.h"
+#include <stdexcept>
+
+RenderQueue::RenderQueue(size_t maxDepth, gnuplot_queue_policy policy) {
+
+    this->maxDepth = (maxDepth > 0) ? maxDepth : 1;
+    this->policy = policy;
+    this->stopping = false;
+
+    this->worker = thread(&RenderQueue::work, this);
+
+}
+
+RenderQueue::~RenderQueue() {
+
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->notEmpty.notify_all();
+    this->worker.join();
+
+}
+
+future<int> RenderQueue::push(function<int()> job) {
+
+    Job j;
+    j.run = move(job);
+    future<int> status = j.status.get_future();
+
+    {
+        unique_lock<mutex> guard(this->lock);
+
+        if (this->jobs.size() >= this->maxDepth) {
+            if (this->policy == gnuplot_queue_policy::GNUPLOT_DROP_OLDEST) {
+                this->jobs.front().status.set_exception(
+                        make_exception_ptr(std::runtime_error("render job dropped: queue is full")));
+                this->jobs.pop_front();
+            } else {
+                this->notFull.wait(guard, [this] { return this->jobs.size() < this->maxDepth; });
+            }
+        }
+
+        this->jobs.push_back(move(j));
+    }
+    this->notEmpty.notify_one();
+
+    return status;
+
+}
+
+size_t RenderQueue::pending() {
+
+    lock_guard<mutex> guard(this->lock);
+    return this->jobs.size();
+
+}
+
+void RenderQueue::work() {
+
+    while (true) {
+        Job j;
+        {
+            unique_lock<mutex> guard(this->lock);
+            this->notEmpty.wait(guard, [this] { return this->stopping || !this->jobs.empty(); });
+            if (this->jobs.empty()) return; // stopping and nothing left to do
+            j = move(this->jobs.front());
+            this->jobs.pop_front();
+        }
+        this->notFull.notify_one();
+
+        try {
+            j.status.set_value(j.run());
+        } catch (...) {
+            j.status.set_exception(current_exception());
+        }
+    }
+
+}
@@ -0,0 +1,353 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "RetainedPlot.h"
+#include "NumberFormat.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+
+RetainedPlot::RetainedPlot(gnuplot_action_type action_type, string fileName, gnuplot_save_type format)
+        : session(action_type == gnuplot_action_type::GNUPLOT_PLOT) {
+
+    if (action_type != gnuplot_action_type::GNUPLOT_PLOT && action_type != gnuplot_action_type::GNUPLOT_SAVE) {
+        cout<<"\n\n[ERROR] a retained plot can only be plotted (GNUPLOT_PLOT) or saved (GNUPLOT_SAVE).\n\n"<<endl;
+        throw std::runtime_error("RetainedPlot::RetainedPlot(gnuplot_action_type action_type, string fileName, gnuplot_save_type format)");
+    }
+
+    this->action = action_type;
+    this->saveType = format;
+    this->saveName = fileName;
+    this->saveWidth = 0;
+    this->saveHeight = 0;
+    this->axisType = gnuplot_axis_type::GNUPLOT_LINEAR;
+    this->titleFontSize = 0;
+    this->xLabelFontSize = 20;
+    this->yLabelFontSize = 20;
+    this->xRangeSet = false;
+    this->yRangeSet = false;
+    this->xRangeMin = this->xRangeMax = 0;
+    this->yRangeMin = this->yRangeMax = 0;
+    this->nextHandle = 0;
+    this->sessionStarts = 0;
+
+}
+
+void RetainedPlot::setTitle(const string &title, const int &fontSize) {
+
+    this->titleText = title;
+    this->titleFontSize = fontSize;
+
+}
+
+void RetainedPlot::setXLabel(const string &str, const int &fontSize) {
+
+    this->xLabelText = str;
+    this->xLabelFontSize = fontSize;
+
+}
+
+void RetainedPlot::setYLabel(const string &str, const int &fontSize) {
+
+    this->yLabelText = str;
+    this->yLabelFontSize = fontSize;
+
+}
+
+void RetainedPlot::setXRange(const double &x0, const double &x1) {
+
+    this->xRangeSet = true;
+    this->xRangeMin = x0;
+    this->xRangeMax = x1;
+
+}
+
+void RetainedPlot::setYRange(const double &y0, const double &y1) {
+
+    this->yRangeSet = true;
+    this->yRangeMin = y0;
+    this->yRangeMax = y1;
+
+}
+
+void RetainedPlot::clearXRange() {
+
+    this->xRangeSet = false;
+
+}
+
+void RetainedPlot::clearYRange() {
+
+    this->yRangeSet = false;
+
+}
+
+void RetainedPlot::setAxisType(const gnuplot_axis_type &axis) {
+
+    this->axisType = axis;
+
+}
+
+void RetainedPlot::setSaveName(const string &fileName) {
+
+    this->saveName = fileName;
+
+}
+
+void RetainedPlot::setSaveSize(const size_t &width, const size_t &height) {
+
+    this->saveWidth = width;
+    this->saveHeight = height;
+
+}
+
+void RetainedPlot::setOption(const string &name, const string &command) {
+
+    this->options[name] = command;
+
+}
+
+size_t RetainedPlot::addSeries(const DataView &x, const DataView &y, const string &title, const string &style) {
+
+    const size_t handle = this->nextHandle++;
+
+    Series& s = this->series[handle];
+    s.title = title;
+    s.style = style;
+    setData(handle, x, y);
+
+    return handle;
+
+}
+
+RetainedPlot::Series& RetainedPlot::find(const size_t &handle, const string &caller) {
+
+    map<size_t, Series>::iterator s = this->series.find(handle);
+    if (s == this->series.end()) {
+        cout<<"\n\n[ERROR] there is no series " << handle << " in the plot.\n\n"<<endl;
+        throw std::runtime_error(caller);
+    }
+
+    return s->second;
+
+}
+
+void RetainedPlot::setData(const size_t &handle, const DataView &x, const DataView &y) {
+
+    Series& s = find(handle, "void RetainedPlot::setData(const size_t &handle, const DataView &x, const DataView &y)");
+
+    if (x.size() != y.size()) {
+        cout<<"\n\n[ERROR] x and y must have same dimension.\n\n"<<endl;
+        throw std::runtime_error("void RetainedPlot::setData(const size_t &handle, const DataView &x, const DataView &y)");
+    }
+
+    s.x.resize(x.size());
+    s.y.resize(y.size());
+    x.copyTo(s.x.data());
+    y.copyTo(s.y.data());
+    s.changed = true;
+
+}
+
+void RetainedPlot::setSeriesTitle(const size_t &handle, const string &title) {
+
+    find(handle, "void RetainedPlot::setSeriesTitle(const size_t &handle, const string &title)").title = title;
+
+}
+
+void RetainedPlot::setSeriesStyle(const size_t &handle, const string &style) {
+
+    find(handle, "void RetainedPlot::setSeriesStyle(const size_t &handle, const string &style)").style = style;
+
+}
+
+void RetainedPlot::removeSeries(const size_t &handle) {
+
+    find(handle, "void RetainedPlot::removeSeries(const size_t &handle)");
+    this->series.erase(handle);
+
+}
+
+void RetainedPlot::invalidate() {
+
+    this->sentSettings.clear();
+    this->sentData.clear();
+    this->sentPlot.clear();
+    this->sentOutput.clear();
+
+}
+
+map<string, string> RetainedPlot::settings() const {
+
+    map<string, string> wanted;
+
+    if (this->action == gnuplot_action_type::GNUPLOT_SAVE) {
+        if (this->saveType == gnuplot_save_type::GNUPLOT_EPS) {
+            wanted["terminal"] = "set term epscairo";
+        } else {
+            wanted["terminal"] = "set term png";
+            if (this->saveWidth > 0 && this->saveHeight > 0)
+                wanted["terminal"] += " size " + to_string(this->saveWidth) + "," + to_string(this->saveHeight);
+        }
+    }
+
+    switch (this->axisType) {
+    case gnuplot_axis_type::GNUPLOT_XLOG:
+        wanted["logscale"] = "unset logscale\nset logscale x";
+        break;
+    case gnuplot_axis_type::GNUPLOT_YLOG:
+        wanted["logscale"] = "unset logscale\nset logscale y";
+        break;
+    case gnuplot_axis_type::GNUPLOT_LOGLOG:
+        wanted["logscale"] = "unset logscale\nset logscale xy";
+        break;
+    default:
+        wanted["logscale"] = "unset logscale";
+        break;
+    }
+
+    wanted["title"] = "set title \"" + this->titleText + "\"";
+    if (this->titleFontSize > 0) wanted["title"] += " font \"," + to_string(this->titleFontSize) + "\"";
+    wanted["xlabel"] = "set xlabel \"" + this->xLabelText + "\" font \"," + to_string(this->xLabelFontSize) + "\"";
+    wanted["ylabel"] = "set ylabel \"" + this->yLabelText + "\" font \"," + to_string(this->yLabelFontSize) + "\"";
+    wanted["xrange"] = this->xRangeSet ? "set xrange [" + formatNumber(this->xRangeMin) + ":" + formatNumber(this->xRangeMax) + "]"
+                                       : "set xrange [*:*]";
+    wanted["yrange"] = this->yRangeSet ? "set yrange [" + formatNumber(this->yRangeMin) + ":" + formatNumber(this->yRangeMax) + "]"
+                                       : "set yrange [*:*]";
+
+    // as in GnuplotDriver, the legend is shown if any series has a title
+    bool titled = false;
+    for (map<size_t, Series>::const_iterator s = this->series.begin(); s != this->series.end(); ++s) titled |= !s->second.title.empty();
+    wanted["key"] = titled ? "set key" : "unset key";
+
+    // names of user options cannot clash with the ones above
+    for (map<string, string>::const_iterator o = this->options.begin(); o != this->options.end(); ++o) wanted["option " + o->first] = o->second;
+
+    return wanted;
+
+}
+
+string RetainedPlot::blockName(const size_t &handle) {
+
+    return "$SP_S" + to_string(handle);
+
+}
+
+uint64_t RetainedPlot::hashData(const Series &s) {
+
+    Hasher64 hasher;
+    const uint64_t n = s.x.size();
+    hasher.update(&n, sizeof(n));
+    hasher.update(s.x.data(), n * sizeof(double));
+    hasher.update(s.y.data(), n * sizeof(double));
+
+    return hasher.digest();
+
+}
+
+string RetainedPlot::plotCommand() const {
+
+    string command;
+
+    for (map<size_t, Series>::const_iterator s = this->series.begin(); s != this->series.end(); ++s) {
+        // empty datablocks are not plotted: gnuplot would stop at them
+        if (s->second.x.empty()) continue;
+        command += command.empty() ? "plot " : ", ";
+        command += blockName(s->first) + " using 1:2 " + s->second.style;
+        command += s->second.title.empty() ? " notitle" : " title \"" + s->second.title + "\"";
+    }
+
+    return command;
+
+}
+
+int RetainedPlot::render() {
+
+    this->stats = PlotStats();
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    // a gnuplot started since last render (or to be started now) holds nothing of ours
+    if (!this->session.isAlive() || this->session.startCount() != this->sessionStarts) invalidate();
+
+    string script;
+
+    const map<string, string> wanted = settings();
+    for (map<string, string>::const_iterator s = wanted.begin(); s != wanted.end(); ++s) {
+        map<string, string>::const_iterator sent = this->sentSettings.find(s->first);
+        if (sent == this->sentSettings.end() || sent->second != s->second) script += s->second + "\n";
+    }
+
+    // datablocks of the series whose data is not the one in gnuplot
+    map<size_t, uint64_t> blocks;
+    for (map<size_t, Series>::iterator s = this->series.begin(); s != this->series.end(); ++s) {
+        map<size_t, uint64_t>::const_iterator sent = this->sentData.find(s->first);
+        if (!s->second.changed && sent != this->sentData.end()) {
+            blocks[s->first] = sent->second;
+            continue;
+        }
+
+        const uint64_t hash = hashData(s->second);
+        blocks[s->first] = hash;
+        if (sent != this->sentData.end() && sent->second == hash) continue;
+
+        ostringstream block;
+        block << blockName(s->first) << " << EOD\n";
+        writeTextData(block, {DataView(s->second.x), DataView(s->second.y)});
+        block << "EOD\n";
+        script += block.str();
+        this->stats.dataBytes += block.str().size();
+        this->stats.pointsWritten += s->second.x.size();
+    }
+    for (map<size_t, uint64_t>::const_iterator sent = this->sentData.begin(); sent != this->sentData.end(); ++sent) {
+        if (blocks.find(sent->first) == blocks.end()) script += "undefine " + blockName(sent->first) + "\n";
+    }
+
+    const string command = plotCommand();
+    const string output = (this->action == gnuplot_action_type::GNUPLOT_SAVE) ? this->saveName : "";
+    for (map<size_t, Series>::iterator s = this->series.begin(); s != this->series.end(); ++s) s->second.changed = false;
+
+    if (script.empty() && command == this->sentPlot && output == this->sentOutput) return 0;
+
+    if (command.empty()) {
+        cout << "[WARNING] there is no data to plot." << endl;
+    } else if (output.empty()) {
+        script += command + "\n";
+    } else {
+        // the output is closed after every plot, so the exported file is complete
+        script += "set output \"" + output + "\"\n" + command + "\nunset output\n";
+    }
+    this->stats.commandBytes = script.size() - this->stats.dataBytes;
+    this->stats.serializeSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    const chrono::steady_clock::time_point sent = chrono::steady_clock::now();
+    const int status = this->session.update(script);
+    this->stats.runSeconds = chrono::duration<double>(chrono::steady_clock::now() - sent).count();
+    this->stats.status = status;
+
+    if (status == 0) {
+        this->sentSettings = wanted;
+        this->sentData = blocks;
+        this->sentPlot = command;
+        this->sentOutput = output;
+        this->sessionStarts = this->session.startCount();
+    } else {
+        invalidate();
+    }
+
+    return status;
+
+}
@@ -0,0 +1,37 @@
+//============================================================
+//
+//      Type:        simplePlot implementation file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+#include "RingBuffer.h"
+
+RingBuffer::RingBuffer(const size_t &capacity) {
+
+    this->cap = (capacity > 0) ? capacity : 1;
+    this->data = vector<double>(4 * this->cap, 0.0);
+    this->pushed = 0;
+
+}
+
+void RingBuffer::push(const double &x, const double &y) {
+
+    const size_t slot = (size_t) (this->pushed % this->cap);
+
+    this->data[2 * slot] = x;
+    this->data[2 * slot + 1] = y;
+    this->data[2 * (slot + this->cap)] = x;
+    this->data[2 * (slot + this->cap) + 1] = y;
+
+    ++this->pushed;
+
+}
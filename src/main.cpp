@@ -14,6 +14,7 @@
 //============================================================
 
 #include "GnuplotDriver.h"
+#include "Figure.h"
 
 using namespace std;
 
@@ -37,4 +38,25 @@ int main(){
     save.setTitleFont(20);
     save.plot(tmp,tmp,tmp,tmp1);
 
-}
\ No newline at end of file
+    // many plots through ONE gnuplot process, the driver is reused for every output file
+    GnuplotDriver session(gnuplot_axis_type::GNUPLOT_LINEAR,
+                          gnuplot_action_type::GNUPLOT_SAVE,
+                          "figure_0.png",gnuplot_save_type::GNUPLOT_PNG);
+    session.setSession(GnuplotSession::processSession());
+    session.setTitle("prova");
+    for (int i = 0; i < 3; ++i) {
+        session.setSaveName("figure_" + to_string(i) + ".png");
+        session.plot(tmp,tmp1);
+    }
+
+    // many panels in one page, rendered by one gnuplot run
+    Figure page(1, 2, gnuplot_action_type::GNUPLOT_SAVE, "page.png");
+    page.setTitle("prova");
+    page.panel(0, 0).setTitle("left");
+    page.panel(0, 1).setTitle("right");
+    page.panel(0, 1).setLegendTitles({"tmp1"});
+    page.plot(0, 0, tmp, tmp);
+    page.plot(0, 1, tmp, tmp1);
+    page.render();
+
+}
@@ -0,0 +1,178 @@
+//============================================================
+//
+//      Type:        simplePlot tool file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// simplePlot: plots columns of text data files (csv or blank separated) from the shell. Files are mapped
+// and parsed in parallel chunks (see DataFile::readColumns), then plotted in place; parse throughput is reported.
+//
+// usage: simplePlot [options] file...
+//   -x N                column of x, from 1 as in gnuplot, 0 for the row number; default 1
+//   -y N[,N...]         columns of y, one series each; default 2
+//   -s, --separator C   column separator; default , for .csv files, blanks otherwise
+//   --skip N            header lines
+//   --every N           one row every N
+//   --logx, --logy, --loglog
+//   -o, --output FILE   exports FILE instead of opening a window, eps if FILE ends in .eps, png otherwise
+//   --size WxH          size of png exports in pixels
+//   --title T, --xlabel T, --ylabel T
+//   --with STYLE        gnuplot plot style, default lines
+//   --decimate PIXELS   min/max decimation for a plot PIXELS wide, rows in order of x
+//   --binary            sends data to gnuplot as binary
+//   --threads N         parsing threads, default one per core
+//   -q, --quiet         no throughput report
+
+#include "GnuplotDriver.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace std;
+
+static void usage() {
+
+    cout << "usage: simplePlot [-x N] [-y N[,N...]] [-s C] [--skip N] [--every N] [--logx|--logy|--loglog]\n"
+            "                  [-o FILE] [--size WxH] [--title T] [--xlabel T] [--ylabel T] [--with STYLE]\n"
+            "                  [--decimate PIXELS] [--binary] [--threads N] [-q] file..." << endl;
+
+}
+
+static bool endsWith(const string& s, const string& suffix) {
+
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+
+}
+
+// columns of a comma separated list, from 1
+static vector<size_t> parseColumns(const string& list) {
+
+    vector<size_t> columns;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        const size_t comma = min(list.find(',', pos), list.size());
+        const size_t c = strtoull(list.substr(pos, comma - pos).c_str(), NULL, 10);
+        if (c > 0) columns.push_back(c);
+        pos = comma + 1;
+    }
+    return columns;
+
+}
+
+int main(int argc, char** argv){
+
+    size_t xColumn = 1;
+    vector<size_t> yColumns = {2};
+    string separator;
+    bool separatorSet = false;
+    FileLayout layout;
+    gnuplot_axis_type axis = gnuplot_axis_type::GNUPLOT_LINEAR;
+    string output, title, xLabel, yLabel, style = "with lines";
+    size_t width = 0, height = 0, pixels = 0, threads = 0;
+    bool binary = false, quiet = false;
+    vector<string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "-x" && hasValue) xColumn = strtoull(argv[++i], NULL, 10);
+        else if (arg == "-y" && hasValue) yColumns = parseColumns(argv[++i]);
+        else if ((arg == "-s" || arg == "--separator") && hasValue) { separator = argv[++i]; separatorSet = true; }
+        else if (arg == "--skip" && hasValue) layout.skip = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--every" && hasValue) layout.stride = max<size_t>(1, strtoull(argv[++i], NULL, 10));
+        else if (arg == "--logx") axis = gnuplot_axis_type::GNUPLOT_XLOG;
+        else if (arg == "--logy") axis = gnuplot_axis_type::GNUPLOT_YLOG;
+        else if (arg == "--loglog") axis = gnuplot_axis_type::GNUPLOT_LOGLOG;
+        else if ((arg == "-o" || arg == "--output") && hasValue) output = argv[++i];
+        else if (arg == "--size" && hasValue) {
+            if (sscanf(argv[++i], "%zux%zu", &width, &height) != 2) width = height = 0;
+        }
+        else if (arg == "--title" && hasValue) title = argv[++i];
+        else if (arg == "--xlabel" && hasValue) xLabel = argv[++i];
+        else if (arg == "--ylabel" && hasValue) yLabel = argv[++i];
+        else if (arg == "--with" && hasValue) style = string("with ") + argv[++i];
+        else if (arg == "--decimate" && hasValue) pixels = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--binary") binary = true;
+        else if (arg == "--threads" && hasValue) threads = strtoull(argv[++i], NULL, 10);
+        else if (arg == "-q" || arg == "--quiet") quiet = true;
+        else if (!arg.empty() && arg[0] != '-') files.push_back(arg);
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if (files.empty() || yColumns.empty()) {
+        usage();
+        return 1;
+    }
+
+    // columns read from every file, from 0: x first, if not the row number
+    vector<size_t> columns;
+    if (xColumn > 0) columns.push_back(xColumn - 1);
+    for (size_t k = 0; k < yColumns.size(); ++k) columns.push_back(yColumns[k] - 1);
+
+    // parsed columns of every file, and the row numbers if x is the row number
+    vector<vector<vector<double>>> data(files.size());
+    vector<vector<double>> rowNumbers(files.size());
+    vector<DataView> x, y;
+    vector<string> titles;
+
+    try {
+        for (size_t f = 0; f < files.size(); ++f) {
+            layout.separator = separatorSet ? (separator.empty() ? 0 : separator[0]) : (endsWith(files[f], ".csv") ? ',' : 0);
+            const DataFile file(files[f], layout);
+
+            const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            const size_t nRows = file.readColumns(columns, data[f], threads);
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            if (!quiet) {
+                const double mb = file.bytes() / 1e6;
+                fprintf(stderr, "%s: %zu rows, %.1f MB parsed in %.3f s (%.0f MB/s)\n",
+                        files[f].c_str(), nRows, mb, seconds, (seconds > 0) ? mb / seconds : 0.0);
+            }
+
+            if (xColumn == 0) for (size_t r = 0; r < nRows; ++r) rowNumbers[f].push_back(r);
+            const DataView xValues = (xColumn > 0) ? DataView(data[f][0]) : DataView(rowNumbers[f]);
+            for (size_t k = 0; k < yColumns.size(); ++k) {
+                x.push_back(xValues);
+                y.push_back(DataView(data[f][(xColumn > 0) ? k + 1 : k]));
+                titles.push_back(files[f] + ":" + to_string(yColumns[k]));
+            }
+        }
+
+        const gnuplot_save_type format = endsWith(output, ".eps") ? gnuplot_save_type::GNUPLOT_EPS : gnuplot_save_type::GNUPLOT_PNG;
+        GnuplotDriver driver(axis, output.empty() ? gnuplot_action_type::GNUPLOT_PLOT : gnuplot_action_type::GNUPLOT_SAVE,
+                             output.empty() ? "plot.png" : output, format);
+        if (!title.empty()) driver.setTitle(title);
+        if (!xLabel.empty()) driver.setXLabel(xLabel);
+        if (!yLabel.empty()) driver.setYLabel(yLabel);
+        if (width > 0 && height > 0) driver.setSaveSize(width, height);
+        if (pixels > 0) driver.setDecimation(gnuplot_decimation_type::GNUPLOT_MINMAX, pixels);
+        if (binary) driver.setDataFormat(gnuplot_data_format::GNUPLOT_BINARY);
+        driver.setPlotOptions(style);
+        // a legend only if there is more than one series
+        if (titles.size() > 1) driver.setLegendTitles(titles);
+
+        driver.plot(x, y);
+    } catch (std::exception&) {
+        return 1;
+    }
+
+    return 0;
+
+}
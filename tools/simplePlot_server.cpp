@@ -0,0 +1,85 @@
+//============================================================
+//
+//      Type:        simplePlot tool file
+//
+//      Author:      Tommaso Bellosta
+//                   Dipartimento di Scienze e Tecnologie Aerospaziali
+//                   Politecnico di Milano
+//                   Via La Masa 34, 20156 Milano, ITALY
+//                   e-mail: tommaso.bellosta@polimi.it
+//
+//      Copyright:   2019, Tommaso Bellosta and the simplePlot contributors.
+//                   This software is distributed under the MIT license, see LICENSE.txt
+//
+//============================================================
+
+// simplePlot-server: keeps a pool of gnuplot sessions and runs the plots of the drivers connected to it
+// (see GnuplotDriver::setServer) until SIGINT or SIGTERM.
+//
+// usage: simplePlot-server [options]
+//   --socket PATH       socket to listen on, default $XDG_RUNTIME_DIR/simplePlot.sock or /tmp/simplePlot-<uid>.sock
+//   --workers N         gnuplot sessions, default one per core
+//   --queue N           jobs waiting at most, default 1024
+//   --batch N           jobs a worker takes at once, default 8
+//   --stats             prints the stats of the server running on the socket and exits
+
+#include "PlotServer.h"
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <cstdlib>
+#include <csignal>
+
+using namespace std;
+
+static PlotServer* running = NULL;
+
+static void stopServer(int) {
+
+    if (running) running->stop();
+
+}
+
+int main(int argc, char** argv){
+
+    string socket = defaultServerSocket();
+    size_t workers = 0, queue = 1024, batch = 8;
+    bool printStats = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--socket" && hasValue) socket = argv[++i];
+        else if (arg == "--workers" && hasValue) workers = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--queue" && hasValue) queue = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--batch" && hasValue) batch = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--stats") printStats = true;
+        else {
+            cout << "usage: simplePlot-server [--socket PATH] [--workers N] [--queue N] [--batch N] [--stats]" << endl;
+            return 1;
+        }
+    }
+
+    try {
+        if (printStats) {
+            cout << PlotClient(socket).stats().toText();
+            return 0;
+        }
+
+        PlotServer server(socket, workers, queue, batch);
+        running = &server;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+
+        cout << "simplePlot-server listening on " << server.socket() << " with " << server.stats().workers << " workers" << endl;
+        server.run();
+        running = NULL;
+
+        cout << server.stats().toText();
+    } catch (std::exception&) {
+        return 1;
+    }
+
+    return 0;
+
+}